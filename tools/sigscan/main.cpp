@@ -0,0 +1,563 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gram_index.h"
+#include "image_scanner.h"
+#include "mapped_file.h"
+#include "pattern.h"
+#include "pe_image.h"
+#include "signature_cache.h"
+#include "xref_scanner.h"
+
+namespace chrono = std::chrono;
+namespace stdfs = std::filesystem;
+
+/*
+ * Offline signature scanner. Resolves signatures against an executable on disk and records them in a signature cache
+ * file, which the DLL loads from its home directory (signatures.cache). Offsets for a new build can then be
+ * precomputed before the game is ever launched.
+*/
+
+constexpr const char* DEFAULT_CACHE_FILE = "signatures.cache";
+constexpr size_t DEFAULT_BENCH_MEGABYTES = 256;
+
+static void PrintUsage()
+{
+    std::fprintf(stderr,
+                 "usage:\n"
+                 "  sigscan scan <image> <signature list> [cache file]\n"
+                 "      Resolve every signature in the list and record the results in the cache file\n"
+                 "      (default: %s). The list has one 'Name: pattern' per line, '#' starts a comment.\n"
+                 "  sigscan bench [megabytes]\n"
+                 "      Measure scanning throughput over a synthetic buffer (default: %zu MB).\n"
+                 "  sigscan selftest\n"
+                 "      Check the scanners against a naive reference on random buffers.\n",
+                 DEFAULT_CACHE_FILE, DEFAULT_BENCH_MEGABYTES);
+}
+
+struct NamedPattern
+{
+    std::string Name;
+    Pattern Compiled;
+};
+
+/**
+ * @brief Read a signature list.
+ * @return false if the file could not be read or has a malformed line
+ */
+static bool ReadSignatureList(const stdfs::path& path, std::vector<NamedPattern>& out)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "could not open %s\n", path.string().c_str());
+        return false;
+    }
+
+    std::string line;
+    for (int line_number = 1; std::getline(in, line); line_number++)
+    {
+        if (const size_t comment = line.find('#'); comment != std::string::npos)
+            line.resize(comment);
+
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos)
+        {
+            std::fprintf(stderr, "%s:%d: expected 'Name: pattern'\n", path.string().c_str(), line_number);
+            return false;
+        }
+
+        std::string name = line.substr(0, colon);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+
+        std::optional<Pattern> pattern = Pattern::Compile(line.substr(colon + 1));
+        if (name.empty() || !pattern.has_value())
+        {
+            std::fprintf(stderr, "%s:%d: malformed signature\n", path.string().c_str(), line_number);
+            return false;
+        }
+
+        out.push_back({std::move(name), std::move(pattern.value())});
+    }
+
+    return true;
+}
+
+static int Scan(const stdfs::path& image_path, const stdfs::path& list_path, const stdfs::path& cache_path)
+{
+    std::vector<NamedPattern> signatures;
+    if (!ReadSignatureList(list_path, signatures))
+        return 1;
+
+    const std::optional<MappedFile> file = MappedFile::Open(image_path);
+    if (!file.has_value())
+    {
+        std::fprintf(stderr, "could not map %s\n", image_path.string().c_str());
+        return 1;
+    }
+
+    const std::optional<PEImage> image = PEImage::FromFile(file->Data(), file->Size());
+    if (!image.has_value())
+    {
+        std::fprintf(stderr, "%s is not a PE32+ image\n", image_path.string().c_str());
+        return 1;
+    }
+
+    SignatureCache cache(cache_path);
+    const ImageScanner scanner(image.value(), ModuleIdentity::FromImage(image_path.filename().string(), *image),
+                               &cache);
+
+    std::vector<Pattern> patterns;
+    patterns.reserve(signatures.size());
+    for (const NamedPattern& signature : signatures)
+        patterns.push_back(signature.Compiled);
+
+    const auto start = chrono::steady_clock::now();
+    const std::vector<const uint8_t*>& matches = scanner.FindMany(patterns);
+    const auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    const ModuleIdentity& identity = scanner.Identity();
+    std::printf("# %s %x %x %llx\n", identity.Name.c_str(), identity.TimeDateStamp, identity.SizeOfImage,
+                static_cast<unsigned long long>(identity.TextHash));
+
+    int missing = 0;
+    for (size_t i = 0; i < signatures.size(); i++)
+    {
+        const std::optional<uint32_t>& rva = matches[i] != nullptr ? image->PointerToRva(matches[i]) : std::nullopt;
+        if (!rva.has_value())
+        {
+            std::fprintf(stderr, "not found: %s\n", signatures[i].Name.c_str());
+            missing++;
+            continue;
+        }
+
+        std::printf("%-32s 0x%08x %s\n", signatures[i].Name.c_str(), rva.value(),
+                    signatures[i].Compiled.ToString().c_str());
+    }
+
+    std::fprintf(stderr, "resolved %zu/%zu signatures in %lld ms, cache: %s\n", signatures.size() - missing,
+                 signatures.size(), static_cast<long long>(elapsed.count()), cache_path.string().c_str());
+    return missing == 0 ? 0 : 2;
+}
+
+/**
+ * @brief Time a scan, returning throughput in MB/s.
+ */
+template <typename F>
+static double Measure(const size_t size, F&& scan)
+{
+    constexpr int ITERATIONS = 5;
+
+    // Best of a few runs, the first one also pays for page faults.
+    double best = 0.0;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        const auto start = chrono::steady_clock::now();
+        scan();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best = std::max(best, static_cast<double>(size) / (1024.0 * 1024.0) / elapsed.count());
+    }
+    return best;
+}
+
+static int Bench(const size_t megabytes)
+{
+    const size_t size = megabytes * 1024 * 1024;
+
+    // The needle is planted at the very end, random bytes are all but certain not to contain it earlier.
+    std::vector<uint8_t> buffer(size);
+    std::mt19937_64 random(0x5EED);
+    for (size_t i = 0; i + 8 <= size; i += 8)
+    {
+        const uint64_t value = random();
+        std::memcpy(&buffer[i], &value, sizeof(value));
+    }
+
+    const Pattern pattern = Pattern::Compile("48 8B 05 ? ? ? ? 48 8B 0C C8 48 8D 04 D1 EB").value();
+    std::memcpy(&buffer[size - pattern.Size()], pattern.Bytes().data(), pattern.Size());
+    for (size_t i = 0; i < pattern.Size(); i++)
+    {
+        if (pattern.Mask()[i] == 0)
+            buffer[size - pattern.Size() + i] = 0xCC;
+    }
+
+    const uint8_t* begin = buffer.data();
+    const uint8_t* end = begin + size;
+    const uint8_t* expected = end - pattern.Size();
+
+    std::printf("%zu MB, %u hardware threads\n", megabytes, std::thread::hardware_concurrency());
+
+    const double single = Measure(size, [&]
+    {
+        if (PatternScanner::Find(begin, end, pattern) != expected)
+            std::abort();
+    });
+    std::printf("%-24s %10.1f MB/s\n", "Find", single);
+
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const double parallel = Measure(size, [&]
+        {
+            if (PatternScanner::FindParallel(begin, end, pattern, threads) != expected)
+                std::abort();
+        });
+
+        const std::string& label = "FindParallel x" + std::to_string(threads);
+        std::printf("%-24s %10.1f MB/s %6.2fx\n", label.c_str(), parallel, parallel / single);
+    }
+
+    // Many signatures in one pass, the shape of a bootstrap.
+    std::vector<Pattern> many;
+    for (int i = 0; i < 32; i++)
+    {
+        std::vector<uint8_t> bytes(12);
+        for (uint8_t& byte : bytes)
+            byte = static_cast<uint8_t>(random());
+        many.push_back(Pattern::FromBytes(bytes.data(), bytes.size()));
+    }
+    const MultiPattern multi(std::move(many));
+
+    const double batch = Measure(size, [&]
+    {
+        PatternScanner::FindMany(begin, end, multi);
+    });
+    std::printf("%-24s %10.1f MB/s (%zu patterns)\n", "FindMany", batch, multi.Count());
+
+    // Repeated lookups through an n-gram index, capped so the index (four bytes per byte) stays a reasonable size.
+    {
+        const size_t indexed_size = std::min<size_t>(size, 64 * 1024 * 1024);
+        const GramIndex index(begin, begin + indexed_size);
+
+        std::vector<Pattern> lookups;
+        for (int i = 0; i < 1024; i++)
+        {
+            const size_t offset = random() % (indexed_size - 16);
+            std::vector<uint8_t> bytes(buffer.begin() + offset, buffer.begin() + offset + 16);
+            lookups.push_back(Pattern::FromBytes(bytes.data(), bytes.size()));
+        }
+
+        const auto start = chrono::steady_clock::now();
+        for (const Pattern& lookup : lookups)
+        {
+            if (!index.Find(lookup).has_value())
+                std::abort();
+        }
+        const chrono::duration<double, std::micro> elapsed = chrono::steady_clock::now() - start;
+
+        std::printf("%-24s %10.1f ms (%zu MB indexed, %zu MB index)\n", "GramIndex build",
+                    static_cast<double>(index.BuildTime().count()) / 1000.0, indexed_size / (1024 * 1024),
+                    index.MemoryUsage() / (1024 * 1024));
+        std::printf("%-24s %10.2f us/lookup (%.1f candidates)\n", "GramIndex Find",
+                    elapsed.count() / static_cast<double>(lookups.size()),
+                    static_cast<double>(index.Candidates()) / static_cast<double>(lookups.size()));
+    }
+
+    // Cross references to a single address and to a batch of addresses spread over a .data-sized region.
+    const uint8_t* xref_target = begin + size / 2;
+    const double xref = Measure(size, [&]
+    {
+        XrefScanner::Find(begin, end, xref_target);
+    });
+    std::printf("%-24s %10.1f MB/s\n", "FindXrefs", xref);
+
+    std::vector<const uint8_t*> xref_targets;
+    for (int i = 0; i < 1024; i++)
+        xref_targets.push_back(begin + size / 2 + random() % (16 * 1024 * 1024));
+
+    const double xref_batch = Measure(size, [&]
+    {
+        XrefScanner::FindMany(begin, end, xref_targets);
+    });
+    std::printf("%-24s %10.1f MB/s (%zu targets)\n", "FindXrefsMany", xref_batch, xref_targets.size());
+
+    return 0;
+}
+
+/**
+ * @brief Naive scalar reference the scanner is checked against: compare every position byte by byte.
+ */
+static std::vector<const uint8_t*> ReferenceFindAll(const uint8_t* begin, const uint8_t* end, const Pattern& pattern)
+{
+    std::vector<const uint8_t*> matches;
+    const size_t size = pattern.Size();
+    if (static_cast<size_t>(end - begin) < size)
+        return matches;
+
+    for (const uint8_t* at = begin; at <= end - size; at++)
+    {
+        bool match = true;
+        for (size_t i = 0; i < size && match; i++)
+            match = (at[i] & pattern.Mask()[i]) == (pattern.Bytes()[i] & pattern.Mask()[i]);
+
+        if (match)
+            matches.push_back(at);
+    }
+    return matches;
+}
+
+enum class WildcardShape
+{
+    None,
+    Leading,
+    AllButOne,
+    Random,
+    Count
+};
+
+/**
+ * @brief Build a pattern from size bytes at data, replacing some of them with wildcards.
+ */
+static Pattern MakePattern(const uint8_t* data, const size_t size, const WildcardShape shape, std::mt19937_64& random)
+{
+    std::vector<bool> concrete(size, true);
+    switch (shape)
+    {
+    case WildcardShape::Leading:
+        std::fill_n(concrete.begin(), random() % size, false);
+        break;
+    case WildcardShape::AllButOne:
+        std::fill(concrete.begin(), concrete.end(), false);
+        concrete[random() % size] = true;
+        break;
+    case WildcardShape::Random:
+        for (size_t i = 0; i < size; i++)
+            concrete[i] = random() % 3 != 0;
+        concrete[random() % size] = true;
+        break;
+    default:
+        break;
+    }
+
+    std::string signature;
+    for (size_t i = 0; i < size; i++)
+    {
+        char token[4];
+        std::snprintf(token, sizeof(token), "%02X ", data[i]);
+        signature += concrete[i] ? token : "? ";
+    }
+    return Pattern::Compile(signature).value();
+}
+
+static void FillRandom(std::vector<uint8_t>& buffer, const unsigned alphabet, std::mt19937_64& random)
+{
+    for (uint8_t& byte : buffer)
+        byte = static_cast<uint8_t>(random() % alphabet);
+}
+
+/**
+ * @brief Compare every single-pattern entry point against the reference matches over [begin, end).
+ * @return Number of mismatches
+ */
+static int CheckPattern(const uint8_t* begin, const uint8_t* end, const Pattern& pattern,
+                        const std::vector<const uint8_t*>& expected, const char* label)
+{
+    const uint8_t* expected_first = expected.empty() ? nullptr : expected.front();
+
+    int failures = 0;
+    const auto report = [&](const char* function, const unsigned threads)
+    {
+        std::fprintf(stderr, "selftest: %s: %s x%u disagrees with the reference for '%s' over %zu bytes\n", label,
+                     function, threads, pattern.ToString().c_str(), static_cast<size_t>(end - begin));
+        failures++;
+    };
+
+    if (PatternScanner::Find(begin, end, pattern) != expected_first)
+        report("Find", 1);
+
+    std::vector<const uint8_t*> repeated;
+    for (const uint8_t* at = PatternScanner::Find(begin, end, pattern); at != nullptr;
+         at = PatternScanner::Find(at + 1, end, pattern))
+    {
+        repeated.push_back(at);
+    }
+    if (repeated != expected)
+        report("Find (repeated)", 1);
+
+    for (const unsigned threads : {1u, 2u, 3u, 8u})
+    {
+        if (PatternScanner::FindParallel(begin, end, pattern, threads) != expected_first)
+            report("FindParallel", threads);
+
+        if (PatternScanner::FindAllParallel(begin, end, pattern, 0, threads) != expected)
+            report("FindAllParallel", threads);
+
+        const size_t limit = 3;
+        const std::vector<const uint8_t*> limited(expected.begin(),
+                                                  expected.begin() + std::min(limit, expected.size()));
+        if (PatternScanner::FindAllParallel(begin, end, pattern, limit, threads) != limited)
+            report("FindAllParallel (limit)", threads);
+    }
+    return failures;
+}
+
+/**
+ * @brief Compare FindMany against the reference first match of each pattern in a set over [begin, end).
+ * @return Number of mismatches
+ */
+static int CheckMany(const uint8_t* begin, const uint8_t* end, const std::vector<Pattern>& patterns,
+                     const std::vector<const uint8_t*>& expected, const char* label)
+{
+    const std::vector<const uint8_t*> found = PatternScanner::FindMany(begin, end, MultiPattern(patterns));
+
+    int failures = 0;
+    for (size_t i = 0; i < patterns.size(); i++)
+    {
+        if (found[i] != expected[i])
+        {
+            std::fprintf(stderr, "selftest: %s: FindMany disagrees with the reference for '%s' over %zu bytes\n",
+                         label, patterns[i].ToString().c_str(), static_cast<size_t>(end - begin));
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Check the vectorized and parallel scanners against a naive scalar reference on random buffers. Run once per
+ *        build flavour (SIGSCAN_AVX2 on and off) since each compiles a different scanner.
+ */
+static int SelfTest()
+{
+    std::mt19937_64 random(0x5EED);
+    int failures = 0;
+    int checks = 0;
+
+    // Buffers and patterns shorter than a vector, so every match sits in a tail. Each buffer ends exactly at the end
+    // of its allocation so reads past the range are caught by sanitizers, and starts at every alignment.
+    for (size_t size = 1; size <= 96; size++)
+    {
+        for (const unsigned alphabet : {2u, 256u})
+        {
+            const size_t shift = random() % 32;
+            std::vector<uint8_t> storage(shift + size);
+            FillRandom(storage, alphabet, random);
+
+            const uint8_t* begin = storage.data() + shift;
+            const uint8_t* end = begin + size;
+
+            std::vector<Pattern> patterns;
+            for (int i = 0; i < 8; i++)
+            {
+                const size_t pattern_size = 1 + random() % std::min<size_t>(size, 40);
+                const size_t offsets[] = {0, size - pattern_size, random() % (size - pattern_size + 1)};
+                const auto shape = static_cast<WildcardShape>(random() % static_cast<int>(WildcardShape::Count));
+                patterns.push_back(MakePattern(begin + offsets[i % 3], pattern_size, shape, random));
+            }
+
+            // A pattern longer than the range can never match.
+            std::vector<uint8_t> longer(size + 1);
+            FillRandom(longer, alphabet, random);
+            patterns.push_back(Pattern::FromBytes(longer.data(), longer.size()));
+
+            std::vector<const uint8_t*> firsts;
+            for (const Pattern& pattern : patterns)
+            {
+                const std::vector<const uint8_t*> expected = ReferenceFindAll(begin, end, pattern);
+                firsts.push_back(expected.empty() ? nullptr : expected.front());
+                failures += CheckPattern(begin, end, pattern, expected, "short buffer");
+                checks++;
+            }
+            failures += CheckMany(begin, end, patterns, firsts, "short buffer");
+            checks++;
+        }
+    }
+
+    // Buffers large enough for the parallel scanners to split, with patterns planted on chunk boundaries and at the
+    // first and last byte, and ranges trimmed so they end in a tail shorter than a vector.
+    constexpr size_t large_size = 5 * 1024 * 1024;
+    std::vector<uint8_t> storage(large_size);
+    FillRandom(storage, 256, random);
+
+    for (int round = 0; round < 4; round++)
+    {
+        const size_t head = random() % 32;
+        const size_t tail = random() % 32;
+        const uint8_t* begin = storage.data() + head;
+        const uint8_t* end = storage.data() + large_size - tail;
+        const size_t range = static_cast<size_t>(end - begin);
+
+        const size_t pattern_size = 1 + random() % 40;
+        std::vector<size_t> offsets = {0, range - pattern_size};
+        for (const unsigned threads : {2u, 3u, 8u})
+        {
+            // Mirrors the chunking in FindParallel: threads * 4 chunks of equal size.
+            const size_t chunk_count = threads * 4;
+            const size_t chunk_size = (range + chunk_count - 1) / chunk_count;
+            for (size_t chunk = 1; chunk < chunk_count; chunk++)
+                offsets.push_back(chunk * chunk_size - random() % (pattern_size + 1));
+        }
+
+        std::vector<Pattern> patterns;
+        std::vector<const uint8_t*> firsts;
+        for (const size_t offset : offsets)
+        {
+            const auto shape = static_cast<WildcardShape>(random() % static_cast<int>(WildcardShape::Count));
+            patterns.push_back(MakePattern(begin + offset, pattern_size, shape, random));
+
+            const std::vector<const uint8_t*> expected = ReferenceFindAll(begin, end, patterns.back());
+            firsts.push_back(expected.empty() ? nullptr : expected.front());
+            failures += CheckPattern(begin, end, patterns.back(), expected, "chunk boundary");
+            checks++;
+        }
+        failures += CheckMany(begin, end, patterns, firsts, "chunk boundary");
+        checks++;
+
+        // The same bytes on every boundary: each straddling match must be reported exactly once.
+        const std::vector<uint8_t> planted = patterns.front().Bytes();
+        std::vector<uint8_t> copy(storage);
+        uint8_t* copy_begin = copy.data() + head;
+        for (const size_t offset : offsets)
+            std::memcpy(copy_begin + offset, planted.data(), planted.size());
+
+        const Pattern repeated = Pattern::FromBytes(planted.data(), planted.size());
+        failures += CheckPattern(copy_begin, copy_begin + range, repeated,
+                                 ReferenceFindAll(copy_begin, copy_begin + range, repeated), "repeated on boundaries");
+        checks++;
+    }
+
+#if defined(__AVX2__)
+    constexpr const char* scanner = "AVX2";
+#else
+    constexpr const char* scanner = "SSE2";
+#endif
+    std::printf("%d checks (%s scanner), %d failed\n", checks, scanner, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+int main(const int argc, char** argv)
+{
+    if (argc >= 2 && std::strcmp(argv[1], "scan") == 0 && (argc == 4 || argc == 5))
+        return Scan(argv[2], argv[3], argc == 5 ? argv[4] : DEFAULT_CACHE_FILE);
+
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0 && argc <= 3)
+    {
+        const size_t megabytes = argc == 3 ? std::strtoull(argv[2], nullptr, 10) : DEFAULT_BENCH_MEGABYTES;
+        if (megabytes == 0)
+        {
+            PrintUsage();
+            return 1;
+        }
+        return Bench(megabytes);
+    }
+
+    if (argc == 2 && std::strcmp(argv[1], "selftest") == 0)
+        return SelfTest();
+
+    PrintUsage();
+    return 1;
+}
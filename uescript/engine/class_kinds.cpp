@@ -0,0 +1,137 @@
+#include <uescript.h>
+#include "class_kinds.h"
+#include "engine.h"
+
+#include <algorithm>
+
+/** Longer chains are assumed to be garbage, real ones are around ten deep **/
+static constexpr size_t MAX_CHAIN_LENGTH = 64;
+
+static constexpr std::pair<std::string_view, ClassKind> KIND_NAMES[] = {
+    {"Field", ClassKind::Field},
+    {"Struct", ClassKind::Struct},
+    {"ScriptStruct", ClassKind::ScriptStruct},
+    {"Class", ClassKind::Class},
+    {"Function", ClassKind::Function},
+    {"Enum", ClassKind::Enum},
+    {"Property", ClassKind::Property},
+    {"BoolProperty", ClassKind::BoolProperty},
+    {"NumericProperty", ClassKind::NumericProperty},
+    {"ByteProperty", ClassKind::ByteProperty},
+    {"Int8Property", ClassKind::Int8Property},
+    {"Int16Property", ClassKind::Int16Property},
+    {"IntProperty", ClassKind::IntProperty},
+    {"Int64Property", ClassKind::Int64Property},
+    {"UInt16Property", ClassKind::UInt16Property},
+    {"UInt32Property", ClassKind::UInt32Property},
+    {"UInt64Property", ClassKind::UInt64Property},
+    {"FloatProperty", ClassKind::FloatProperty},
+    {"DoubleProperty", ClassKind::DoubleProperty},
+    {"StrProperty", ClassKind::StrProperty},
+    {"NameProperty", ClassKind::NameProperty},
+    {"TextProperty", ClassKind::TextProperty},
+    {"ObjectPropertyBase", ClassKind::ObjectPropertyBase},
+    {"ObjectProperty", ClassKind::ObjectProperty},
+    {"ClassProperty", ClassKind::ClassProperty},
+    {"WeakObjectProperty", ClassKind::WeakObjectProperty},
+    {"SoftObjectProperty", ClassKind::SoftObjectProperty},
+    {"InterfaceProperty", ClassKind::InterfaceProperty},
+    {"StructProperty", ClassKind::StructProperty},
+    {"ArrayProperty", ClassKind::ArrayProperty},
+    {"MapProperty", ClassKind::MapProperty},
+    {"SetProperty", ClassKind::SetProperty},
+    {"EnumProperty", ClassKind::EnumProperty},
+    {"DelegateProperty", ClassKind::DelegateProperty},
+    {"MulticastDelegateProperty", ClassKind::MulticastDelegateProperty},
+};
+
+ClassKind MostDerivedKind(const ClassKinds& kinds)
+{
+    for (size_t i = kinds.size(); i > 0; i--)
+    {
+        if (kinds.test(i - 1))
+            return static_cast<ClassKind>(i - 1);
+    }
+
+    return ClassKind::Max;
+}
+
+std::string_view ClassKindName(const ClassKind kind)
+{
+    const auto it = std::ranges::find(KIND_NAMES, kind, &std::pair<std::string_view, ClassKind>::second);
+    return it != std::end(KIND_NAMES) ? it->first : std::string_view{};
+}
+
+ClassKindCache::Entry ClassKindCache::Compute(const UObject* klass)
+{
+    const auto* klass_struct = reinterpret_cast<const UStruct*>(klass);
+
+    Entry entry{klass->Name.v.CompositeComparisonValue, klass_struct->SuperStruct};
+
+    std::array<char, 512> name_buf{};
+    for (const UStruct* current = klass_struct; current != nullptr && entry.Chain.size() < MAX_CHAIN_LENGTH;
+         current = current->SuperStruct)
+    {
+        const UObject* object = &current->Super.Super;
+        entry.Chain.push_back(object);
+
+        const std::string_view& name = UE::GetAsciiObjectNameFast(object, name_buf);
+        if (const auto kind = std::ranges::find(KIND_NAMES, name, &std::pair<std::string_view, ClassKind>::first);
+            kind != std::end(KIND_NAMES))
+        {
+            entry.Kinds.set(static_cast<size_t>(kind->second));
+        }
+    }
+
+    return entry;
+}
+
+template <typename F>
+auto ClassKindCache::With(const UObject* klass, F&& f)
+{
+    const uint64_t name = klass->Name.v.CompositeComparisonValue;
+    const UStruct* super_struct = reinterpret_cast<const UStruct*>(klass)->SuperStruct;
+
+    {
+        const std::shared_lock lock(m_Mutex);
+        if (const auto it = m_Entries.find(klass); it != m_Entries.end() && it->second.Name == name &&
+            it->second.SuperStruct == super_struct)
+        {
+            return f(it->second);
+        }
+    }
+
+    // Names are resolved without holding the lock, racing threads compute the same entry.
+    Entry entry = Compute(klass);
+
+    const std::unique_lock lock(m_Mutex);
+    return f(m_Entries.insert_or_assign(klass, std::move(entry)).first->second);
+}
+
+ClassKinds ClassKindCache::Get(const UObject* klass)
+{
+    if (klass == nullptr)
+        return {};
+
+    return With(klass, [](const Entry& entry)
+    {
+        return entry.Kinds;
+    });
+}
+
+bool ClassKindCache::IsA(const UObject* object, const UObject* klass)
+{
+    if (object == nullptr || object->Class == nullptr || klass == nullptr)
+        return false;
+
+    return With(object->Class, [klass](const Entry& entry)
+    {
+        return std::ranges::find(entry.Chain, klass) != entry.Chain.end();
+    });
+}
+
+void ClassKindCache::Clear()
+{
+    const std::unique_lock lock(m_Mutex);
+    m_Entries.clear();
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+
+#include <bitset>
+#include <unordered_map>
+
+/**
+ * @brief What a class describes. A class has the kind of every class in its SuperStruct chain, so UClassProperty is
+ *        also an ObjectPropertyBase and a Property. Kinds are declared after their bases.
+ */
+enum class ClassKind : uint8_t
+{
+    Field,
+    Struct,
+    ScriptStruct,
+    Class,
+    Function,
+    Enum,
+    Property,
+    BoolProperty,
+    NumericProperty,
+    ByteProperty,
+    Int8Property,
+    Int16Property,
+    IntProperty,
+    Int64Property,
+    UInt16Property,
+    UInt32Property,
+    UInt64Property,
+    FloatProperty,
+    DoubleProperty,
+    StrProperty,
+    NameProperty,
+    TextProperty,
+    ObjectPropertyBase,
+    ObjectProperty,
+    ClassProperty,
+    WeakObjectProperty,
+    SoftObjectProperty,
+    InterfaceProperty,
+    StructProperty,
+    ArrayProperty,
+    MapProperty,
+    SetProperty,
+    EnumProperty,
+    DelegateProperty,
+    MulticastDelegateProperty,
+    // Must be last
+    Max,
+};
+
+using ClassKinds = std::bitset<static_cast<size_t>(ClassKind::Max)>;
+
+inline bool HasKind(const ClassKinds& kinds, const ClassKind kind)
+{
+    return kinds.test(static_cast<size_t>(kind));
+}
+
+/**
+ * @return The most derived kind in a set, e.g. ClassProperty for a UClassProperty, or Max if the set is empty.
+ */
+ClassKind MostDerivedKind(const ClassKinds& kinds);
+
+/**
+ * @return The name of a kind without the U prefix, e.g. "IntProperty".
+ */
+std::string_view ClassKindName(ClassKind kind);
+
+/**
+ * @brief Classifies classes once by walking their SuperStruct chain, keyed by the class object.
+ *
+ * Entries remember the name and SuperStruct they were computed from and are recomputed if either changed, in case the
+ * class was destroyed and its memory reused. Lookups take a shared lock, so the cache can be used from the reflection
+ * workers.
+ */
+class ClassKindCache final
+{
+public:
+    /**
+     * @return The kinds of a class, none if it is null.
+     */
+    ClassKinds Get(const UObject* klass);
+
+    /**
+     * @return Whether the class of an object is klass or derives from it.
+     */
+    bool IsA(const UObject* object, const UObject* klass);
+
+    void Clear();
+
+private:
+    struct Entry
+    {
+        uint64_t Name{0};
+        const UStruct* SuperStruct{nullptr};
+        ClassKinds Kinds{};
+        /** The class itself followed by its SuperStruct chain **/
+        std::vector<const UObject*> Chain{};
+    };
+
+    static Entry Compute(const UObject* klass);
+
+    /**
+     * @brief Run f on the up to date entry of a class under the shared lock.
+     */
+    template <typename F>
+    auto With(const UObject* klass, F&& f);
+
+    std::shared_mutex m_Mutex{};
+    std::unordered_map<const UObject*, Entry> m_Entries{};
+};
+
+inline ClassKindCache g_ClassKinds;
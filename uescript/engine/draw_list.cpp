@@ -0,0 +1,171 @@
+#include <uescript.h>
+#include "draw_list.h"
+#include "engine.h"
+#include "text_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr uint32_t INITIAL_CAPACITY = 4096;
+static constexpr uint32_t INITIAL_TEXT_CAPACITY = 64 * 1024;
+
+static FLinearColor UnpackColor(const uint32_t color)
+{
+    return FLinearColor::FromRGBA(color & 0xFF, color >> 8 & 0xFF, color >> 16 & 0xFF, color >> 24 & 0xFF);
+}
+
+bool DrawList::Grow()
+{
+    if (m_Commands.size() >= MAX_COMMANDS)
+        return false;
+
+    const size_t capacity = m_Commands.empty() ? INITIAL_CAPACITY : std::min<size_t>(m_Commands.size() * 2,
+        MAX_COMMANDS);
+    m_Commands.resize(capacity);
+
+    m_Buffer.Commands = m_Commands.data();
+    m_Buffer.Capacity = static_cast<uint32_t>(m_Commands.size());
+    return true;
+}
+
+bool DrawList::GrowText(const uint32_t size)
+{
+    if (size > MAX_TEXT_SIZE)
+        return false;
+
+    if (size <= m_Text.size())
+        return true;
+
+    const size_t capacity = std::clamp<size_t>(m_Text.size() * 2, std::max(size, INITIAL_TEXT_CAPACITY),
+                                               MAX_TEXT_SIZE);
+    m_Text.resize(capacity);
+
+    m_Buffer.Text = m_Text.data();
+    m_Buffer.TextCapacity = static_cast<uint32_t>(m_Text.size());
+    return true;
+}
+
+uint32_t DrawList::Intern(const std::string_view text)
+{
+    if (const std::optional<uint32_t>& id = m_Strings.Find(text); id.has_value())
+        return id.value();
+
+    if (m_Strings.Size() >= MAX_STRINGS)
+    {
+        if (!m_IsInternFull)
+        {
+            std::cout << std::format("unreal.draw.Intern: {} strings are interned already, pass strings that change "
+                                     "to unreal.draw.Text instead", MAX_STRINGS) << std::endl;
+            m_IsInternFull = true;
+        }
+        return NO_TEXT;
+    }
+
+    const uint32_t id = m_Strings.Intern(text);
+    m_WideStrings.push_back(StringUtl::AsciiToWideString(text));
+    return id;
+}
+
+void DrawList::Flush(UObject* canvas)
+{
+    const auto& start = chrono::steady_clock::now();
+
+    m_Stats.Commands = {};
+    m_Stats.Dropped = m_Buffer.Dropped;
+
+    const uint32_t count = std::min(m_Buffer.Count, m_Buffer.Capacity);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const DrawCommand& command = m_Commands[i];
+        const FLinearColor& color = UnpackColor(command.Color);
+
+        switch (command.Type)
+        {
+        case DrawCommandType::Line:
+            g_EP.DrawLine(canvas, Vector2{command.X, command.Y}, Vector2{command.X2, command.Y2}, command.Thickness,
+                          color);
+            break;
+        case DrawCommandType::Rect:
+            UE::DrawRect(canvas, Vector2{command.X, command.Y}, Vector2{command.X2, command.Y2}, command.Thickness,
+                         color);
+            break;
+        case DrawCommandType::FilledRect:
+        {
+            const auto hud = reinterpret_cast<UObject*>(command.Object);
+            if (hud == nullptr)
+                continue;
+
+            UE::DrawFilledRect(canvas, hud, command.X, command.Y, command.X2, command.Y2, color);
+            break;
+        }
+        case DrawCommandType::Text:
+        {
+            const auto font = reinterpret_cast<void*>(command.Object);
+            if (command.Text >= TRANSIENT_TEXT)
+            {
+                const std::optional<std::string_view>& text = FrameText(command.Text - TRANSIENT_TEXT);
+                if (!text.has_value())
+                    continue;
+
+                UE::DrawText(canvas, font, g_TextCache.Get(text.value()), Vector2{command.X, command.Y}, color,
+                             command.Outlined);
+                break;
+            }
+
+            if (command.Text >= m_WideStrings.size())
+                continue;
+
+            const std::wstring& text = m_WideStrings[command.Text];
+            const FString str{
+                text.c_str(), static_cast<int32_t>(text.size() + 1), static_cast<int32_t>(text.size() + 1)
+            };
+            UE::DrawText(canvas, font, str, Vector2{command.X, command.Y}, color, command.Outlined);
+            break;
+        }
+        default:
+            continue;
+        }
+
+        m_Stats.Commands[static_cast<size_t>(command.Type)]++;
+    }
+
+    if (m_Stats.Dropped > 0 && !m_IsDropping)
+    {
+        std::cout << std::format("unreal.draw: dropped {} commands this frame, the draw list holds at most {} "
+                                 "commands and {} bytes of text", m_Stats.Dropped, MAX_COMMANDS, MAX_TEXT_SIZE)
+            << std::endl;
+    }
+    m_IsDropping = m_Stats.Dropped > 0;
+
+    m_Buffer.Count = 0;
+    m_Buffer.Dropped = 0;
+    m_Buffer.TextSize = 0;
+    m_Stats.Flush = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+}
+
+std::optional<std::string_view> DrawList::FrameText(const uint32_t offset) const
+{
+    const uint32_t size = std::min(m_Buffer.TextSize, static_cast<uint32_t>(m_Text.size()));
+    if (offset >= size)
+        return {};
+
+    // Lua copies strings with their terminator, anything else is not one of them.
+    const char* begin = m_Text.data() + offset;
+    const auto* end = static_cast<const char*>(std::memchr(begin, '\0', size - offset));
+    if (end == nullptr)
+        return {};
+
+    return std::string_view(begin, end);
+}
+
+void DrawList::Reset()
+{
+    m_Buffer.Count = 0;
+    m_Buffer.Dropped = 0;
+    m_Buffer.TextSize = 0;
+    m_Strings.Clear();
+    m_WideStrings.clear();
+    m_Stats = {};
+    m_IsDropping = false;
+    m_IsInternFull = false;
+}
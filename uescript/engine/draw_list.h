@@ -0,0 +1,143 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+
+#include <utils/string_pool.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+enum class DrawCommandType : uint8_t
+{
+    Line,
+    Rect,
+    FilledRect,
+    Text,
+    Max,
+};
+
+/**
+ * @brief One queued draw call. Written from Lua through the FFI, so the layout must match the declaration in
+ *        unreal_sdk.cpp.
+ */
+struct DrawCommand
+{
+    DrawCommandType Type; // 0x0000
+    bool Outlined; // 0x0001
+    uint16_t Reserved; // 0x0002
+    /** R in the low byte, then G, B and A **/
+    uint32_t Color; // 0x0004
+    /** From and to for lines, position and size for rects, position for text **/
+    float X; // 0x0008
+    float Y; // 0x000C
+    float X2; // 0x0010
+    float Y2; // 0x0014
+    float Thickness; // 0x0018
+    /** Id from DrawList::Intern, or TRANSIENT_TEXT plus the offset of the string in the frame's text **/
+    uint32_t Text; // 0x001C
+    /** The HUD for filled rects, the font for text **/
+    uint64_t Object; // 0x0020
+}; // Size: 0x0028
+
+static_assert(sizeof(DrawCommand) == 0x28);
+
+/**
+ * @brief Where Lua appends commands and the strings they draw. Count and TextSize are reset when the list is flushed.
+ */
+struct DrawListBuffer
+{
+    DrawCommand* Commands{nullptr};
+    uint32_t Count{0};
+    uint32_t Capacity{0};
+    /** Commands that did not fit since the last flush **/
+    uint32_t Dropped{0};
+    uint32_t TextSize{0};
+    /** Null-terminated strings drawn this frame **/
+    char* Text{nullptr};
+    uint32_t TextCapacity{0};
+};
+
+/**
+ * @brief What the last flush drew.
+ */
+struct DrawListStats
+{
+    std::array<uint32_t, static_cast<size_t>(DrawCommandType::Max)> Commands{};
+    uint32_t Dropped{0};
+    chrono::microseconds Flush{0};
+};
+
+/**
+ * @brief Draw commands queued by scripts during a frame and replayed against the canvas in one go once the
+ *        DrawTransition callback returns. Lua writes commands straight into the buffer, so queuing a draw never leaves
+ *        a trace. Text is either interned once and referenced by id, or copied into the frame's text by Lua and
+ *        converted through the TextCache when it is drawn.
+ */
+class DrawList final
+{
+public:
+    /** Upper bounds, so a runaway script fails instead of eating memory **/
+    static constexpr uint32_t MAX_COMMANDS = 1 << 20;
+    static constexpr uint32_t MAX_STRINGS = 1 << 16;
+    static constexpr uint32_t MAX_TEXT_SIZE = 1 << 22;
+    static constexpr uint32_t NO_TEXT = UINT32_MAX;
+    /** Set in the text of a command that references the frame's text **/
+    static constexpr uint32_t TRANSIENT_TEXT = 1u << 31;
+
+    DrawListBuffer* Buffer()
+    {
+        return &m_Buffer;
+    }
+
+    /**
+     * @brief Double the capacity of the buffer.
+     * @return false if it is already at MAX_COMMANDS
+     */
+    bool Grow();
+
+    /**
+     * @brief Grow the frame's text to hold at least size bytes.
+     * @return false if that is more than MAX_TEXT_SIZE
+     */
+    bool GrowText(uint32_t size);
+
+    /**
+     * @return The id of a string for text commands, or NO_TEXT if MAX_STRINGS are interned already.
+     */
+    uint32_t Intern(std::string_view text);
+
+    /**
+     * @brief Replay and clear the queued commands and the frame's text. Commands with an unknown type or text are
+     *        skipped. Logs when commands were dropped, once until a frame drops none.
+     */
+    void Flush(UObject* canvas);
+
+    const DrawListStats& Stats() const
+    {
+        return m_Stats;
+    }
+
+    /**
+     * @brief Drop queued commands and interned strings, for a new Lua state.
+     */
+    void Reset();
+
+private:
+    /**
+     * @return The string at an offset in the frame's text, if one starts there.
+     */
+    std::optional<std::string_view> FrameText(uint32_t offset) const;
+
+    std::vector<DrawCommand> m_Commands{};
+    DrawListBuffer m_Buffer{};
+    StringPool m_Strings{};
+    /** Wide copies of m_Strings, by id **/
+    std::vector<std::wstring> m_WideStrings{};
+    std::vector<char> m_Text{};
+    DrawListStats m_Stats{};
+    bool m_IsDropping{false};
+    bool m_IsInternFull{false};
+};
+
+inline DrawList g_DrawList;
@@ -129,3 +129,51 @@ void UE::FreeMemory(void* memory)
 {
     g_EP.FreeMemory(memory);
 }
+
+void UE::DrawText(UObject* canvas, void* font, const FString& text, const Vector2 pos, const FLinearColor color,
+                  const bool outlined)
+{
+    // Defaults, maybe DrawTextEx?
+    constexpr Vector2 scale = {1.f, 1.f};
+    constexpr float kerning = 1.f;
+    constexpr FLinearColor shadow_color = FLinearColor::FromRGBA(0, 0, 0, 255);
+    constexpr Vector2 shadow_offset = {1.f, 1.f};
+    constexpr bool center_x = false;
+    constexpr bool center_y = false;
+    constexpr FLinearColor outline_color = shadow_color;
+
+    g_EP.DrawText(canvas,
+                  font,
+                  text,
+                  pos,
+                  scale,
+                  color,
+                  kerning,
+                  shadow_color,
+                  shadow_offset,
+                  center_x,
+                  center_y,
+                  outlined,
+                  outline_color);
+}
+
+void UE::DrawRect(UObject* canvas, const Vector2 pos, const Vector2 size, const float thickness,
+                  const FLinearColor color)
+{
+    g_EP.DrawLine(canvas, pos, Vector2{pos.X + size.X, pos.Y}, thickness, color);
+    g_EP.DrawLine(canvas, pos, Vector2{pos.X, pos.Y + size.Y}, thickness, color);
+    g_EP.DrawLine(canvas, Vector2{pos.X, pos.Y + size.Y}, Vector2{pos.X + size.X, pos.Y + size.Y}, thickness, color);
+    g_EP.DrawLine(canvas, Vector2{pos.X + size.X, pos.Y}, Vector2{pos.X + size.X, pos.Y + size.Y}, thickness, color);
+}
+
+void UE::DrawFilledRect(UObject* canvas, UObject* hud, const float x, const float y, const float w, const float h,
+                        const FLinearColor color)
+{
+    // FIXME
+    const auto hud_canvas = reinterpret_cast<UObject**>(reinterpret_cast<uint64_t>(hud) + 0x378);
+    UObject* old_canvas = *hud_canvas;
+
+    *hud_canvas = canvas;
+    g_EP.DrawFilledRect(hud, color, x, y, w, h);
+    *hud_canvas = old_canvas;
+}
@@ -2,6 +2,7 @@
 #include <uescript.h>
 #include "objects.h"
 #include "strings.h"
+#include "names.h"
 
 using ProcessEventFn = void (*)(UObject* object, UObject* function, void* params);
 using DrawTransitionFn = void (*)(UObject* viewport_client, UObject* canvas);
@@ -37,7 +38,6 @@ using K2SizeOfTextFn = Vector2 *(*)(UObject* canvas, uint64_t* unk, void* font,
 struct APawn;
 
 using UEngine = uint64_t;
-using TNameEntryArray = uint64_t;
 
 struct EnginePointers
 {
@@ -83,6 +83,13 @@ public:
     template <int Size>
     constexpr static std::string_view GetAsciiObjectNameFast(const UObject* object, std::array<char, Size>& buffer)
     {
+        // Read from GNames when possible, the engine call allocates.
+        if (const std::optional<std::string_view>& name = g_NameTable.ToAscii(object->Name, buffer.data(), Size);
+            name.has_value())
+        {
+            return name.value();
+        }
+
         const UEStr& wide_name = GetObjectName(object);
         return StringUtl::WideToAsciiStringFast(wide_name, buffer);
     }
@@ -91,4 +98,18 @@ public:
     static UObject* StaticFindObject(const std::string_view& path);
     static TArray GetAllActorsOfClass(UObject* world_context, UObject* klass);
     static void FreeMemory(void* memory);
+
+    /**
+     * @brief Draw text at unit scale with a black shadow, and a black outline if outlined.
+     */
+    static void DrawText(UObject* canvas, void* font, const FString& text, Vector2 pos, FLinearColor color,
+                         bool outlined);
+    /**
+     * @brief Draw the outline of a rectangle as four lines.
+     */
+    static void DrawRect(UObject* canvas, Vector2 pos, Vector2 size, float thickness, FLinearColor color);
+    /**
+     * @brief Fill a rectangle through a HUD, which draws to its own canvas, so canvas is swapped in for the call.
+     */
+    static void DrawFilledRect(UObject* canvas, UObject* hud, float x, float y, float w, float h, FLinearColor color);
 };
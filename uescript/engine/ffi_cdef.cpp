@@ -0,0 +1,298 @@
+#include <uescript.h>
+#include "ffi_cdef.h"
+#include "engine.h"
+#include "struct_layout.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <unordered_set>
+
+/** Nested structs deeper than this are emitted as bytes **/
+static constexpr size_t MAX_NESTING = 16;
+
+/** Engine types with a fixed layout, matching objects.h and strings.h **/
+static constexpr std::string_view FNAME_DECLARATION =
+    "typedef struct FName { int32_t ComparisonIndex; int32_t Number; } FName;\n";
+static constexpr std::string_view FSTRING_DECLARATION =
+    "typedef struct FString { uint16_t* Data; int32_t Count; int32_t Max; } FString;\n";
+static constexpr std::string_view TARRAY_DECLARATION =
+    "typedef struct TArray { void* Data; int32_t Count; int32_t Max; } TArray;\n";
+static constexpr std::string_view FLINEARCOLOR_DECLARATION =
+    "typedef struct FLinearColor { float R; float G; float B; float A; } FLinearColor;\n";
+static constexpr std::string_view VECTOR2_DECLARATION = "typedef struct Vector2 { float X; float Y; } Vector2;\n";
+static constexpr std::string_view VECTOR3_DECLARATION =
+    "typedef struct Vector3 { float X; float Y; float Z; } Vector3;\n";
+
+/** Words the FFI parser would not accept as a field name **/
+static constexpr std::string_view RESERVED_NAMES[] = {
+    "auto", "bool", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum", "extern",
+    "float", "for", "goto", "if", "inline", "int", "long", "register", "restrict", "return", "short", "signed",
+    "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while", "_Bool",
+    "int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t", "FName", "FString",
+    "TArray", "FLinearColor", "Vector2", "Vector3",
+};
+
+/**
+ * @return name with anything that is not valid in a C identifier replaced.
+ */
+static std::string Sanitize(const std::string_view name)
+{
+    std::string result;
+    result.reserve(name.size() + 1);
+    if (name.empty() || (name.front() >= '0' && name.front() <= '9'))
+        result += '_';
+
+    for (const char c : name)
+    {
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        result += valid ? c : '_';
+    }
+
+    if (std::ranges::find(RESERVED_NAMES, result) != std::end(RESERVED_NAMES))
+        result += '_';
+
+    return result;
+}
+
+static std::string_view IntegerType(const int32_t size, const bool is_signed)
+{
+    switch (size)
+    {
+    case 1:
+        return is_signed ? "int8_t" : "uint8_t";
+    case 2:
+        return is_signed ? "int16_t" : "uint16_t";
+    case 4:
+        return is_signed ? "int32_t" : "uint32_t";
+    case 8:
+        return is_signed ? "int64_t" : "uint64_t";
+    default:
+        return {};
+    }
+}
+
+std::string CdefGenerator::Add(const UStruct* klass)
+{
+    return Declare(klass, 0);
+}
+
+void CdefGenerator::AddEngineTypes()
+{
+    DeclareBuiltin("FName", FNAME_DECLARATION);
+    DeclareBuiltin("FString", FSTRING_DECLARATION);
+    DeclareBuiltin("TArray", TARRAY_DECLARATION);
+    DeclareBuiltin("FLinearColor", FLINEARCOLOR_DECLARATION);
+    DeclareBuiltin("Vector2", VECTOR2_DECLARATION);
+    DeclareBuiltin("Vector3", VECTOR3_DECLARATION);
+}
+
+std::string CdefGenerator::Finish() const
+{
+    if (m_Declarations.empty())
+        return {};
+
+    return std::format("#pragma pack(push, 1)\n{}#pragma pack(pop)\n", m_Declarations);
+}
+
+std::string CdefGenerator::TypeName(const UStruct* klass)
+{
+    std::array<char, 512> name_buf{};
+    const UObject* object = &klass->Super.Super;
+    const ClassKinds& kinds = g_ClassKinds.Get(object->Class);
+
+    std::string_view prefix;
+    if (HasKind(kinds, ClassKind::Class))
+    {
+        prefix = "U";
+        for (const UStruct* current = klass; current != nullptr; current = current->SuperStruct)
+        {
+            if (UE::GetAsciiObjectNameFast(&current->Super.Super, name_buf) == "Actor")
+            {
+                prefix = "A";
+                break;
+            }
+        }
+    }
+    else if (HasKind(kinds, ClassKind::ScriptStruct))
+    {
+        prefix = "F";
+    }
+
+    return Sanitize(std::format("{}{}", prefix, UE::GetAsciiObjectNameFast(object, name_buf)));
+}
+
+std::string CdefGenerator::Declare(const UStruct* klass, const size_t depth)
+{
+    const std::string& base_name = TypeName(klass);
+    std::string type_name = base_name;
+    for (int suffix = 2;; suffix++)
+    {
+        const auto& [it, inserted] = m_Defined.try_emplace(type_name, DefinedType{klass, klass->PropertiesSize});
+        if (inserted)
+            break;
+
+        if (it->second.Struct == klass && it->second.Size == klass->PropertiesSize)
+            return type_name;
+
+        type_name = std::format("{}_{}", base_name, suffix);
+    }
+
+    std::array<char, 512> name_buf{};
+    std::vector<Field> fields;
+
+    // Names can collide once sanitized, and a field may not share its name with the type.
+    std::unordered_set<std::string> field_names{type_name};
+    const auto& unique_name = [&field_names](std::string name)
+    {
+        while (!field_names.insert(name).second)
+            name += '_';
+        return name;
+    };
+
+    // Bitfield bools share bytes, they are grouped by byte and declared with their bit positions.
+    std::map<int32_t, std::vector<std::pair<int, std::string>>> bit_groups;
+
+    // Nested structs build their own layouts while this one is walked, which can move the span.
+    const std::span<const LayoutProperty>& layout = g_StructLayouts.Get(klass);
+    const std::vector<LayoutProperty> properties(layout.begin(), layout.end());
+
+    for (const LayoutProperty& property : properties)
+    {
+        const std::string& name = unique_name(
+            Sanitize(UE::GetAsciiObjectNameFast(&property.Property->Super, name_buf)));
+
+        if (property.Kind == ClassKind::BoolProperty)
+        {
+            const auto* bool_property = reinterpret_cast<const UBoolProperty*>(property.Property);
+            if (bool_property->FieldMask != 0xFF && std::has_single_bit(bool_property->FieldMask))
+            {
+                bit_groups[property.Offset + bool_property->ByteOffset].emplace_back(
+                    std::countr_zero(bool_property->FieldMask), name);
+                continue;
+            }
+        }
+
+        const int32_t size = property.ElementSize * std::max(property.ArrayDim, 1);
+        const std::string& type = FieldType(property.Property, property.Kind, depth);
+        if (type.empty())
+            fields.push_back({property.Offset, size, std::format("    uint8_t {}[{}];\n", name, size)});
+        else if (property.ArrayDim > 1)
+            fields.push_back({property.Offset, size, std::format("    {} {}[{}];\n", type, name, property.ArrayDim)});
+        else
+            fields.push_back({property.Offset, size, std::format("    {} {};\n", type, name)});
+    }
+
+    for (auto& [offset, bits] : bit_groups)
+    {
+        std::ranges::sort(bits);
+
+        std::string text;
+        int next_bit = 0;
+        for (const auto& [bit, name] : bits)
+        {
+            if (bit < next_bit)
+                continue;
+            if (bit > next_bit)
+                text += std::format("    uint8_t : {};\n", bit - next_bit);
+
+            text += std::format("    uint8_t {} : 1;\n", name);
+            next_bit = bit + 1;
+        }
+        if (next_bit < 8)
+            text += std::format("    uint8_t : {};\n", 8 - next_bit);
+
+        fields.push_back({offset, 1, std::move(text)});
+    }
+
+    std::ranges::stable_sort(fields, {}, &Field::Offset);
+
+    const int32_t struct_size = klass->PropertiesSize;
+    std::string body;
+    int32_t cursor = 0;
+    for (Field& field : fields)
+    {
+        // Overlapping fields are unions in the engine, the first one wins.
+        if (field.Offset < cursor || field.Size <= 0 || field.Offset + field.Size > struct_size)
+            continue;
+
+        if (field.Offset > cursor)
+            body += std::format("    uint8_t _pad_0x{:X}[0x{:X}];\n", cursor, field.Offset - cursor);
+
+        body += field.Text;
+        cursor = field.Offset + field.Size;
+    }
+
+    if (cursor < struct_size)
+        body += std::format("    uint8_t _pad_0x{:X}[0x{:X}];\n", cursor, struct_size - cursor);
+
+    m_Declarations += std::format("typedef struct {} {{\n{}}} {};\n", type_name, body, type_name);
+    return type_name;
+}
+
+std::string CdefGenerator::FieldType(const UProperty* property, const ClassKind kind, const size_t depth)
+{
+    const int32_t size = property->ElementSize;
+
+    const auto& sized = [size](const std::string_view type, const int32_t expected)
+    {
+        return size == expected ? std::string(type) : std::string();
+    };
+
+    switch (kind)
+    {
+    case ClassKind::BoolProperty:
+        return sized("bool", 1);
+    case ClassKind::Int8Property:
+        return sized("int8_t", 1);
+    case ClassKind::Int16Property:
+        return sized("int16_t", 2);
+    case ClassKind::IntProperty:
+        return sized("int32_t", 4);
+    case ClassKind::Int64Property:
+        return sized("int64_t", 8);
+    case ClassKind::UInt16Property:
+        return sized("uint16_t", 2);
+    case ClassKind::UInt32Property:
+        return sized("uint32_t", 4);
+    case ClassKind::UInt64Property:
+        return sized("uint64_t", 8);
+    case ClassKind::FloatProperty:
+        return sized("float", 4);
+    case ClassKind::DoubleProperty:
+        return sized("double", 8);
+    case ClassKind::ByteProperty:
+    case ClassKind::EnumProperty:
+        return std::string(IntegerType(size, false));
+    case ClassKind::NumericProperty:
+        return std::string(IntegerType(size, true));
+    case ClassKind::ObjectProperty:
+    case ClassKind::ClassProperty:
+        return sized("void*", 8);
+    case ClassKind::NameProperty:
+        DeclareBuiltin("FName", FNAME_DECLARATION);
+        return sized("FName", 8);
+    case ClassKind::StrProperty:
+        DeclareBuiltin("FString", FSTRING_DECLARATION);
+        return sized("FString", 16);
+    case ClassKind::ArrayProperty:
+        DeclareBuiltin("TArray", TARRAY_DECLARATION);
+        return sized("TArray", 16);
+    case ClassKind::StructProperty:
+    {
+        const UStruct* nested = reinterpret_cast<const UStructProperty*>(property)->Struct;
+        if (nested == nullptr || depth >= MAX_NESTING || nested->PropertiesSize != size)
+            return {};
+
+        return Declare(nested, depth + 1);
+    }
+    default:
+        return {};
+    }
+}
+
+void CdefGenerator::DeclareBuiltin(const std::string_view name, const std::string_view declaration)
+{
+    if (m_Defined.try_emplace(std::string(name)).second)
+        m_Declarations += declaration;
+}
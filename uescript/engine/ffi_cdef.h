@@ -0,0 +1,90 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+#include "class_kinds.h"
+
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief A type name passed to ffi.cdef and the struct it was declared for.
+ */
+struct DefinedType
+{
+    /** nullptr for engine types and names declared by scripts **/
+    const UStruct* Struct{nullptr};
+    int32_t Size{0};
+};
+
+using DefinedTypes = std::unordered_map<std::string, DefinedType>;
+
+/**
+ * @brief Emits LuaJIT ffi.cdef declarations for structs and classes from their flattened layouts, so scripts can read
+ *        fields through ffi.cast instead of a lua_CFunction per field, which aborts the trace.
+ *
+ * Declarations are packed with explicit padding, so every field sits at the offset the engine uses no matter how the
+ * FFI would align it. Struct properties whose struct has the same size become nested structs, declared first. Fields
+ * without a C equivalent (maps, sets, delegates, text, ...) become byte arrays of the right size.
+ *
+ * A type name belongs to the struct that was declared under it first. Structs from different packages can share a
+ * name, and names can collide once sanitized, so a different struct (or one whose size changed) gets a numbered name.
+ */
+class CdefGenerator final
+{
+public:
+    /**
+     * @param defined Types declared by earlier ffi.cdef calls. They are not declared again, types declared by this
+     *        generator are added.
+     */
+    explicit CdefGenerator(DefinedTypes& defined)
+        : m_Defined(defined)
+    {
+    }
+
+    /**
+     * @brief Declare a struct or class and the structs it contains.
+     * @return The name of its type, e.g. "APlayerController", or "APlayerController_2" if a different struct took
+     *         that name
+     */
+    std::string Add(const UStruct* klass);
+
+    /**
+     * @brief Declare the engine types used by the signatures in engine.h: FName, FString, TArray, FLinearColor, Vector2
+     *        and Vector3.
+     */
+    void AddEngineTypes();
+
+    /**
+     * @return Every declaration added so far, ready for ffi.cdef. Empty if there was nothing new to declare.
+     */
+    std::string Finish() const;
+
+    /**
+     * @return The C type name of a struct or class: the engine's A, U or F prefix and the name made a valid identifier.
+     */
+    static std::string TypeName(const UStruct* klass);
+
+private:
+    struct Field
+    {
+        int32_t Offset{0};
+        int32_t Size{0};
+        /** One or more member declarations **/
+        std::string Text{};
+    };
+
+    std::string Declare(const UStruct* klass, size_t depth);
+
+    /**
+     * @return The C type of a property, or an empty string if it has none and should be emitted as bytes.
+     */
+    std::string FieldType(const UProperty* property, ClassKind kind, size_t depth);
+
+    /**
+     * @brief Declare a type with a fixed layout the first time it is needed.
+     */
+    void DeclareBuiltin(std::string_view name, std::string_view declaration);
+
+    DefinedTypes& m_Defined;
+    std::string m_Declarations{};
+};
@@ -0,0 +1,109 @@
+#include <uescript.h>
+#include "names.h"
+#include "engine.h"
+
+#include <charconv>
+#include <cstring>
+#include <cwchar>
+
+NameTable::~NameTable()
+{
+    for (std::atomic<CachedText*>& chunk : m_Chunks)
+        delete[] chunk.load();
+}
+
+std::optional<NameTable::Text> NameTable::Resolve(const int32_t comparison_index)
+{
+    if (comparison_index < 0 || comparison_index >= TNameEntryArray::MaxTotalElements)
+        return {};
+
+    const size_t chunk_index = comparison_index / TNameEntryArray::ElementsPerChunk;
+    const size_t within_chunk = comparison_index % TNameEntryArray::ElementsPerChunk;
+
+    CachedText* chunk = m_Chunks[chunk_index].load(std::memory_order_acquire);
+    if (chunk != nullptr)
+    {
+        const CachedText& cached = chunk[within_chunk];
+        if (const void* data = cached.Data.load(std::memory_order_acquire); data != nullptr)
+        {
+            const uint32_t length = cached.Length.load(std::memory_order_relaxed);
+            return Text{data, length & ~WIDE_BIT, (length & WIDE_BIT) != 0};
+        }
+    }
+
+    const TNameEntryArray* names = g_EP.GNames != nullptr ? UE::GetGNames() : nullptr;
+    if (names == nullptr)
+        return {};
+
+    const FNameEntry* entry = names->GetEntry(comparison_index);
+    if (entry == nullptr)
+        return {};
+
+    const bool wide = entry->IsWide();
+    const void* data = wide ? static_cast<const void*>(entry->WideName) : static_cast<const void*>(entry->AnsiName);
+    const auto length = static_cast<uint32_t>(wide
+                                                  ? wcsnlen(entry->WideName, NAME_SIZE)
+                                                  : strnlen(entry->AnsiName, NAME_SIZE));
+
+    // Entries never change once they are in GNames, racing threads store the same values.
+    if (chunk == nullptr)
+    {
+        auto* allocated = new CachedText[TNameEntryArray::ElementsPerChunk]{};
+        if (m_Chunks[chunk_index].compare_exchange_strong(chunk, allocated, std::memory_order_acq_rel))
+            chunk = allocated;
+        else
+            delete[] allocated;
+    }
+
+    CachedText& cached = chunk[within_chunk];
+    cached.Length.store(length | (wide ? WIDE_BIT : 0), std::memory_order_relaxed);
+    cached.Data.store(data, std::memory_order_release);
+
+    return Text{data, length, wide};
+}
+
+std::optional<std::string_view> NameTable::ToAscii(const FName& name, char* buffer, const size_t buffer_size)
+{
+    const std::optional<Text>& text = Resolve(name.v.i.ComparisonIndex);
+    if (!text.has_value())
+        return {};
+
+    // ANSI entries are null-terminated, so a name without a number needs no copy at all.
+    const int32_t number = name.v.i.Number;
+    if (!text->Wide && number == 0)
+        return text->Ansi();
+
+    if (text->Length >= buffer_size)
+        return {};
+
+    size_t length = text->Length;
+    if (text->Wide)
+    {
+        // Names are almost always ASCII, anything else is replaced like WideCharToMultiByte does.
+        const std::wstring_view& wide = text->WideText();
+        for (size_t i = 0; i < length; i++)
+            buffer[i] = wide[i] < 0x80 ? static_cast<char>(wide[i]) : '?';
+    }
+    else
+    {
+        std::memcpy(buffer, text->Data, length);
+    }
+
+    // A number of 0 means none, other numbers are stored plus one.
+    if (number != 0)
+    {
+        char* end = buffer + buffer_size - 1;
+        if (length + 1 >= buffer_size)
+            return {};
+
+        buffer[length++] = '_';
+        const auto [ptr, error] = std::to_chars(buffer + length, end, number - 1);
+        if (error != std::errc{})
+            return {};
+
+        length = static_cast<size_t>(ptr - buffer);
+    }
+
+    buffer[length] = '\0';
+    return std::string_view(buffer, length);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+
+/**
+ * @brief Resolves FNames by reading GNames directly instead of calling into the engine.
+ *
+ * Resolved entries are remembered in a table laid out like GNames itself: chunks are allocated once and never move,
+ * so lookups after the first one don't lock or allocate, and the table grows along with GNames.
+ */
+class NameTable final
+{
+public:
+    /**
+     * @brief Text of a name entry as stored by the engine, pointing into the entry.
+     */
+    struct Text
+    {
+        const void* Data{nullptr};
+        uint32_t Length{0};
+        bool Wide{false};
+
+        /** Only valid for ANSI entries **/
+        std::string_view Ansi() const
+        {
+            return {static_cast<const char*>(Data), Length};
+        }
+
+        /** Only valid for wide entries **/
+        std::wstring_view WideText() const
+        {
+            return {static_cast<const wchar_t*>(Data), Length};
+        }
+    };
+
+    NameTable() = default;
+    ~NameTable();
+
+    NameTable& operator=(const NameTable&) = delete;
+    NameTable(const NameTable&) = delete;
+
+    /**
+     * @return The text of a name without its number, or an empty optional if GNames has no such entry (yet).
+     */
+    std::optional<Text> Resolve(int32_t comparison_index);
+
+    /**
+     * @brief Format a name the same way FName::ToString does, e.g. "Actor_3".
+     * @return A null-terminated view into the name entry if it can be used as is, otherwise into buffer. Empty if the
+     *         name can't be resolved or does not fit.
+     */
+    std::optional<std::string_view> ToAscii(const FName& name, char* buffer, size_t buffer_size);
+
+private:
+    struct CachedText
+    {
+        /** Set last, a non-null value means the entry is resolved **/
+        std::atomic<const void*> Data{nullptr};
+        /** Length with the top bit set for wide names **/
+        std::atomic_uint32_t Length{0};
+    };
+
+    static constexpr uint32_t WIDE_BIT = 0x80000000;
+
+    std::array<std::atomic<CachedText*>, TNameEntryArray::ChunkTableSize> m_Chunks{};
+};
+
+inline NameTable g_NameTable;
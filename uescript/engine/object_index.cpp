@@ -0,0 +1,251 @@
+#include <uescript.h>
+#include "object_index.h"
+#include "engine.h"
+
+#include <algorithm>
+
+/** Substring queries whose matching names are remembered **/
+static constexpr size_t MAX_SUBSTRING_QUERIES = 256;
+
+UObject* ObjectIndex::Find(const std::string_view name)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        // Nothing usable was indexed, the object may be newer than the last sync.
+        if (attempt == 1)
+            SyncNewLocked();
+
+        const auto it = m_NameLookup.find(name);
+        if (it == m_NameLookup.end())
+            continue;
+
+        for (const int32_t index : m_Names.at(it->second).Objects)
+        {
+            if (IsCurrent(index))
+                return m_Slots[index].Object;
+        }
+    }
+
+    return nullptr;
+}
+
+std::vector<UObject*> ObjectIndex::FindAll(const std::string_view query, const Match match, const size_t limit)
+{
+    std::scoped_lock lock(m_Mutex);
+    SyncNewLocked();
+
+    // Slots outside the sync window may be stale, they are left out rather than resynced.
+    std::vector<int32_t> indices;
+    const auto collect = [this, &indices](const uint64_t name)
+    {
+        for (const int32_t index : m_Names.at(name).Objects)
+        {
+            if (IsCurrent(index))
+                indices.push_back(index);
+        }
+    };
+
+    switch (match)
+    {
+    case Match::Exact:
+        if (const auto it = m_NameLookup.find(query); it != m_NameLookup.end())
+            collect(it->second);
+        break;
+    case Match::Prefix:
+        {
+            if (m_SortedNamesDirty)
+            {
+                m_SortedNames.assign(m_NameLookup.begin(), m_NameLookup.end());
+                std::ranges::sort(m_SortedNames);
+                m_SortedNamesDirty = false;
+            }
+
+            auto it = std::ranges::lower_bound(m_SortedNames, query, {}, &std::pair<std::string_view, uint64_t>::first);
+            for (; it != m_SortedNames.end() && it->first.starts_with(query); ++it)
+                collect(it->second);
+            break;
+        }
+    case Match::Substring:
+        {
+            // Scripts tend to poll the same queries, and names are rarely added once the game is loaded.
+            auto it = m_SubstringNames.find(std::string(query));
+            if (it == m_SubstringNames.end())
+            {
+                if (m_SubstringNames.size() >= MAX_SUBSTRING_QUERIES)
+                    m_SubstringNames.clear();
+
+                std::vector<uint64_t> names;
+                for (const auto& [name, entry] : m_Names)
+                {
+                    if (entry.Name.find(query) != std::string::npos)
+                        names.push_back(name);
+                }
+                it = m_SubstringNames.emplace(query, std::move(names)).first;
+            }
+
+            for (const uint64_t name : it->second)
+                collect(name);
+            break;
+        }
+    }
+
+    std::ranges::sort(indices);
+    if (limit != 0 && indices.size() > limit)
+        indices.resize(limit);
+
+    std::vector<UObject*> result;
+    result.reserve(indices.size());
+    for (const int32_t index : indices)
+        result.push_back(m_Slots[index].Object);
+
+    return result;
+}
+
+void ObjectIndex::Sync()
+{
+    std::scoped_lock lock(m_Mutex);
+    SyncLocked();
+}
+
+void ObjectIndex::SyncLocked()
+{
+    ResizeLocked();
+    SyncRange(0, static_cast<int32_t>(m_Slots.size()));
+    m_SyncCursor = 0;
+}
+
+void ObjectIndex::SyncNewLocked()
+{
+    const int32_t previous = ResizeLocked();
+    const int32_t count = static_cast<int32_t>(m_Slots.size());
+    const int32_t old_count = std::min(previous, count);
+
+    SyncRange(old_count, count);
+
+    // Reused slots below the watermark are picked up a window at a time.
+    if (m_SyncCursor >= old_count)
+        m_SyncCursor = 0;
+
+    const int32_t end = std::min(m_SyncCursor + SYNC_WINDOW, old_count);
+    SyncRange(m_SyncCursor, end);
+    m_SyncCursor = end;
+}
+
+int32_t ObjectIndex::ResizeLocked()
+{
+    const int32_t previous = static_cast<int32_t>(m_Slots.size());
+    const int32_t count = std::max(g_EP.UObjectArray->NumElements, 0);
+
+    // Slots past the end of the array belong to objects that no longer exist.
+    for (int32_t index = count; index < previous; index++)
+    {
+        if (m_Slots[index].Object != nullptr)
+            Erase(m_Names.at(m_Slots[index].Name).Objects, index);
+    }
+    m_Slots.resize(count);
+
+    return previous;
+}
+
+void ObjectIndex::SyncRange(const int32_t begin, const int32_t end)
+{
+    const UObjectArray* array = g_EP.UObjectArray;
+
+    for (int32_t index = begin; index < end; index++)
+    {
+        const FUObjectItem* item = array->GetObject(index);
+        UObject* object = item != nullptr ? item->Object : nullptr;
+
+        // Only memory is read here, names are resolved for slots that changed.
+        const Slot current{
+            object,
+            object != nullptr ? item->SerialNumber : 0,
+            object != nullptr ? object->Name.v.CompositeComparisonValue : 0
+        };
+
+        Slot& slot = m_Slots[index];
+        if (slot.Object == current.Object && slot.SerialNumber == current.SerialNumber && slot.Name == current.Name)
+            continue;
+
+        if (slot.Object != nullptr)
+            Erase(m_Names.at(slot.Name).Objects, index);
+
+        slot = current;
+
+        if (object != nullptr)
+            Insert(GetNameEntry(current.Name).Objects, index);
+    }
+}
+
+bool ObjectIndex::IsCurrent(const int32_t index) const
+{
+    const UObjectArray* array = g_EP.UObjectArray;
+    if (index >= array->NumElements || index >= static_cast<int32_t>(m_Slots.size()))
+        return false;
+
+    const Slot& slot = m_Slots[index];
+    const FUObjectItem* item = array->GetObject(index);
+    return item != nullptr && item->Object == slot.Object && item->SerialNumber == slot.SerialNumber &&
+        slot.Object->Name.v.CompositeComparisonValue == slot.Name;
+}
+
+ObjectIndex::NameEntry& ObjectIndex::GetNameEntry(const uint64_t name_value)
+{
+    const auto [it, inserted] = m_Names.try_emplace(name_value);
+    if (!inserted)
+        return it->second;
+
+    FName name{};
+    name.v.CompositeComparisonValue = name_value;
+
+    // Same as FName::ToString, a number of 0 means none and other numbers are stored plus one.
+    std::string string = GetBaseName(name.v.i.ComparisonIndex);
+    if (name.v.i.Number != 0)
+        string += std::format("_{}", name.v.i.Number - 1);
+
+    it->second.Name = std::move(string);
+    m_NameLookup.emplace(it->second.Name, it->first);
+    m_SortedNamesDirty = true;
+    m_SubstringNames.clear();
+
+    return it->second;
+}
+
+const std::string& ObjectIndex::GetBaseName(const int32_t comparison_index)
+{
+    const auto [it, inserted] = m_BaseNames.try_emplace(comparison_index);
+    if (!inserted)
+        return it->second;
+
+    const FName base{{{comparison_index, 0}}};
+
+    std::array<char, NAME_SIZE> buffer{};
+    if (const std::optional<std::string_view>& name = g_NameTable.ToAscii(base, buffer.data(), buffer.size());
+        name.has_value())
+    {
+        it->second = name.value();
+        return it->second;
+    }
+
+    const UEStr& string = UE::FNameToString(&base);
+    it->second = StringUtl::WideToAsciiString(string);
+
+    // The conversion includes the terminator.
+    if (!it->second.empty() && it->second.back() == '\0')
+        it->second.pop_back();
+
+    return it->second;
+}
+
+void ObjectIndex::Insert(std::vector<int32_t>& objects, const int32_t index)
+{
+    objects.insert(std::ranges::lower_bound(objects, index), index);
+}
+
+void ObjectIndex::Erase(std::vector<int32_t>& objects, const int32_t index)
+{
+    if (const auto it = std::ranges::lower_bound(objects, index); it != objects.end() && *it == index)
+        objects.erase(it);
+}
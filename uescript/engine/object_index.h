@@ -0,0 +1,108 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Maps object names to the objects in the UObjectArray so lookups don't have to ask the engine for the name
+ *        of every object.
+ *
+ * Names are resolved once per FName ComparisonIndex. Each slot remembers the object, SerialNumber and name it was
+ * indexed with, so a sync pass over the array only reads memory and only resolves names of slots that changed.
+ *
+ * Lookups don't walk the whole array: they index slots added since the last sync and revisit a window of older ones,
+ * so objects in reused slots show up within a few lookups. Results are checked against the array before they are
+ * returned. Sync catches up on every slot at once.
+ */
+class ObjectIndex final
+{
+public:
+    enum class Match
+    {
+        Exact,
+        Prefix,
+        Substring,
+    };
+
+    /**
+     * @brief Find an object by its exact name. New slots are only indexed when none of the indexed candidates are
+     *        still alive, so repeated lookups of existing objects don't touch the rest of the array.
+     */
+    UObject* Find(std::string_view name);
+
+    /**
+     * @brief Find every object whose name matches a query, in ascending index order.
+     * @param limit Maximum number of objects to return, 0 for no limit
+     */
+    std::vector<UObject*> FindAll(std::string_view query, Match match, size_t limit = 0);
+
+    /**
+     * @brief Bring every slot of the index up to date with the UObjectArray.
+     */
+    void Sync();
+
+    /** Old slots revisited by each lookup **/
+    static constexpr int32_t SYNC_WINDOW = 4096;
+
+private:
+    struct Slot
+    {
+        UObject* Object{nullptr};
+        int32_t SerialNumber{0};
+        uint64_t Name{0};
+    };
+
+    struct NameEntry
+    {
+        std::string Name{};
+        /** Object indices, ascending **/
+        std::vector<int32_t> Objects{};
+    };
+
+    void SyncLocked();
+    /**
+     * @brief Index slots added since the last sync and the next SYNC_WINDOW older ones.
+     */
+    void SyncNewLocked();
+    /**
+     * @brief Resize to the array, dropping slots past its end.
+     * @return The previous number of slots
+     */
+    int32_t ResizeLocked();
+    void SyncRange(int32_t begin, int32_t end);
+
+    /**
+     * @return Whether the slot still holds the object it was indexed with.
+     */
+    bool IsCurrent(int32_t index) const;
+
+    /**
+     * @param name FName CompositeComparisonValue
+     */
+    NameEntry& GetNameEntry(uint64_t name);
+    const std::string& GetBaseName(int32_t comparison_index);
+
+    static void Insert(std::vector<int32_t>& objects, int32_t index);
+    static void Erase(std::vector<int32_t>& objects, int32_t index);
+
+    std::mutex m_Mutex{};
+    std::vector<Slot> m_Slots{};
+    /** FName ComparisonIndex to the name without its number **/
+    std::unordered_map<int32_t, std::string> m_BaseNames{};
+    /** FName CompositeComparisonValue to the objects with that name **/
+    std::unordered_map<uint64_t, NameEntry> m_Names{};
+    /** Name string to CompositeComparisonValue. Views point into m_Names, whose nodes never move. **/
+    std::unordered_map<std::string_view, uint64_t> m_NameLookup{};
+    /** Names in lexicographic order for prefix queries, rebuilt after new names are added **/
+    std::vector<std::pair<std::string_view, uint64_t>> m_SortedNames{};
+    bool m_SortedNamesDirty{false};
+    /** Names containing recent substring queries, cleared when a name is added **/
+    std::unordered_map<std::string, std::vector<uint64_t>> m_SubstringNames{};
+    /** Next old slot revisited by SyncNewLocked **/
+    int32_t m_SyncCursor{0};
+};
+
+inline ObjectIndex g_ObjectIndex;
@@ -74,7 +74,98 @@ struct UProperty
     int32_t ArrayDim;
     int32_t ElementSize;
     char _pad[0x9];
-    int32_t Offset_Internal;
+    int32_t Offset_Internal; // 0x0044
+    struct FName RepNotifyFunc; // 0x0048
+    struct UProperty* PropertyLinkNext; // 0x0050
+    struct UProperty* NextRef; // 0x0058
+    struct UProperty* DestructorLinkNext; // 0x0060
+    struct UProperty* PostConstructLinkNext; // 0x0068
+}; // Size: 0x0070
+
+struct UBoolProperty
+{
+    UProperty Super;
+    uint8_t FieldSize; // 0x0070
+    uint8_t ByteOffset; // 0x0071
+    uint8_t ByteMask; // 0x0072
+    /** 0xFF for a native bool, a single bit for a bitfield **/
+    uint8_t FieldMask; // 0x0073
+};
+
+struct UStructProperty
+{
+    UProperty Super;
+    struct UStruct* Struct; // 0x0070
+}; // Size: 0x0078
+
+struct UField
+{
+    UObject Super;
+    struct UField* Next; // 0x0028
+}; // Size: 0x0030
+
+struct UStruct
+{
+    UField Super;
+    struct UStruct* SuperStruct; // 0x0030
+    struct UField* Children; // 0x0038
+    int32_t PropertiesSize; // 0x0040
+    int32_t MinAlignment; // 0x0044
+    BasicTArray<uint8_t> Script; // 0x0048
+    struct UProperty* PropertyLink; // 0x0058
+    struct UProperty* RefLink; // 0x0060
+    struct UProperty* DestructorLink; // 0x0068
+    struct UProperty* PostConstructLink; // 0x0070
+    TArray ScriptObjectReferences; // 0x0078
+}; // Size: 0x0088
+
+/** Maximum length of a name, including the terminator **/
+constexpr int32_t NAME_SIZE = 1024;
+
+struct FNameEntry
+{
+    /** Index of the name shifted left by one, the low bit is set for wide names **/
+    int32_t Index; // 0x0000
+    char pad_0004[4]; // 0x0004
+    FNameEntry* HashNext; // 0x0008
+    /** Null-terminated, entries are only allocated as large as their name **/
+    union
+    {
+        char AnsiName[NAME_SIZE];
+        wchar_t WideName[NAME_SIZE];
+    }; // 0x0010
+
+    bool IsWide() const
+    {
+        return (Index & 1) != 0;
+    }
+};
+
+/**
+ * @brief TStaticIndirectArrayThreadSafeRead<FNameEntry, 2 * 1024 * 1024, 16384>. Chunks are allocated on demand and
+ *        never freed, as are the entries they point to.
+ */
+struct TNameEntryArray
+{
+    static constexpr int32_t ElementsPerChunk = 16384;
+    static constexpr int32_t MaxTotalElements = 2 * 1024 * 1024;
+    static constexpr int32_t ChunkTableSize = (MaxTotalElements + ElementsPerChunk - 1) / ElementsPerChunk;
+
+    FNameEntry** Chunks[ChunkTableSize]; // 0x0000
+    int32_t NumElements; // 0x0400
+    int32_t NumChunks; // 0x0404
+
+    /**
+     * @return The entry at an index, nullptr if the slot is not filled in.
+     */
+    const FNameEntry* GetEntry(const int32_t Index) const
+    {
+        if (Index < 0 || Index >= NumElements)
+            return nullptr;
+
+        FNameEntry* const* Chunk = Chunks[Index / ElementsPerChunk];
+        return Chunk != nullptr ? Chunk[Index % ElementsPerChunk] : nullptr;
+    }
 };
 
 struct FUObjectItem
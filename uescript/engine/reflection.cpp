@@ -0,0 +1,324 @@
+#include <uescript.h>
+#include "reflection.h"
+#include "class_kinds.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <unordered_map>
+
+/** Objects handed to a worker at a time, small enough to balance and large enough to not contend **/
+static constexpr int32_t BLOCK_SIZE = 4096;
+
+/**
+ * @brief Per-thread state, only the class kind cache is shared while collecting.
+ */
+struct ReflectionWorker
+{
+    std::vector<ReflectedMember> Members{};
+    /** Classes seen by this worker, so the shared cache is locked once per class rather than once per object **/
+    std::unordered_map<const UObject*, ClassKinds> Kinds{};
+    std::array<char, 512> NameBuf{};
+    std::array<char, 512> OuterNameBuf{};
+
+    void Visit(const int32_t index, UObject* object)
+    {
+        if (object == nullptr || object->Outer == nullptr || object->Class == nullptr)
+            return;
+
+        auto kinds_it = Kinds.find(object->Class);
+        if (kinds_it == Kinds.end())
+            kinds_it = Kinds.emplace(object->Class, g_ClassKinds.Get(object->Class)).first;
+
+        const ClassKinds& kinds = kinds_it->second;
+        const bool is_function = HasKind(kinds, ClassKind::Function);
+        const bool is_property = HasKind(kinds, ClassKind::Property);
+
+        if (!is_function && !is_property)
+            return;
+
+        int64_t offset = 0;
+        int32_t size = 0;
+        if (is_function)
+        {
+            offset = reinterpret_cast<int64_t>(object);
+        }
+        else
+        {
+            const UProperty* prop = reinterpret_cast<UProperty*>(object);
+            if (prop->ElementSize == 0)
+                return;
+
+            offset = prop->Offset_Internal;
+            size = prop->ElementSize;
+        }
+
+        const std::string_view& outer_name = UE::GetAsciiObjectNameFast(object->Outer, OuterNameBuf);
+        const std::string_view& name = UE::GetAsciiObjectNameFast(object, NameBuf);
+
+        Members.push_back({index, std::string(outer_name), std::string(name), offset, size, is_function});
+    }
+};
+
+/**
+ * @brief Visit count objects on a thread pool, where index_at maps a position to an object index.
+ */
+template <typename F>
+static std::vector<ReflectedMember> CollectWith(const size_t count, F&& index_at, ReflectionTiming& timing)
+{
+    const auto& collect_start = chrono::steady_clock::now();
+
+    const UObjectArray* array = g_EP.UObjectArray;
+    const int32_t num_elements = array->NumElements;
+
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<ReflectionWorker> workers(threads);
+    std::atomic_size_t next_block{0};
+
+    const auto work = [&](ReflectionWorker& worker)
+    {
+        for (size_t block = next_block.fetch_add(BLOCK_SIZE); block < count; block = next_block.fetch_add(BLOCK_SIZE))
+        {
+            for (size_t i = block; i < std::min(block + BLOCK_SIZE, count); i++)
+            {
+                const int32_t index = index_at(i);
+                if (index >= num_elements)
+                    break;
+
+                if (const FUObjectItem* item = array->GetObject(index); item != nullptr)
+                    worker.Visit(index, item->Object);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; i++)
+        pool.emplace_back(work, std::ref(workers[i]));
+
+    work(workers[0]);
+
+    for (std::thread& thread : pool)
+        thread.join();
+
+    const auto& merge_start = chrono::steady_clock::now();
+
+    size_t total = 0;
+    for (const ReflectionWorker& worker : workers)
+        total += worker.Members.size();
+
+    std::vector<ReflectedMember> members;
+    members.reserve(total);
+    for (ReflectionWorker& worker : workers)
+        std::ranges::move(worker.Members, std::back_inserter(members));
+
+    // Blocks finish in any order, restore array order so the first object with a name keeps winning.
+    std::ranges::sort(members, {}, &ReflectedMember::ObjectIndex);
+
+    const auto& merge_end = chrono::steady_clock::now();
+
+    timing.Threads = threads;
+    timing.Collect = chrono::duration_cast<chrono::microseconds>(merge_start - collect_start);
+    timing.Merge = chrono::duration_cast<chrono::microseconds>(merge_end - merge_start);
+    return members;
+}
+
+std::vector<ReflectedMember> Reflection::Collect(const int32_t begin, const int32_t end, ReflectionTiming& timing)
+{
+    const size_t count = end > begin ? static_cast<size_t>(end - begin) : 0;
+    return CollectWith(count, [begin](const size_t i)
+    {
+        return begin + static_cast<int32_t>(i);
+    }, timing);
+}
+
+std::vector<ReflectedMember> Reflection::Collect(const std::span<const int32_t> indices, ReflectionTiming& timing)
+{
+    return CollectWith(indices.size(), [indices](const size_t i)
+    {
+        return indices[i];
+    }, timing);
+}
+
+std::vector<ReflectedChange> ReflectionIndex::Update(ReflectionTiming& timing)
+{
+    const auto& scan_start = chrono::steady_clock::now();
+
+    const UObjectArray* array = g_EP.UObjectArray;
+    const int32_t count = std::max(array->NumElements, 0);
+    const int32_t watermark = Watermark();
+
+    // Slots are compared in memory only, anything that differs is crawled again.
+    std::vector<int32_t> changed;
+    std::vector<Slot> current(std::max(count, watermark));
+    for (int32_t index = 0; index < static_cast<int32_t>(current.size()); index++)
+    {
+        if (index < count)
+        {
+            const FUObjectItem* item = array->GetObject(index);
+            if (UObject* object = item != nullptr ? item->Object : nullptr; object != nullptr)
+                current[index] = {object, item->SerialNumber, object->Name.v.CompositeComparisonValue};
+        }
+
+        if (index >= watermark)
+        {
+            changed.push_back(index);
+            continue;
+        }
+
+        const Slot& slot = m_Slots[index];
+        if (slot.Object != current[index].Object || slot.SerialNumber != current[index].SerialNumber ||
+            slot.Name != current[index].Name)
+        {
+            changed.push_back(index);
+            continue;
+        }
+
+        current[index].Member = slot.Member;
+    }
+
+    const auto& scan_end = chrono::steady_clock::now();
+
+    const std::vector<ReflectedMember>& members = Reflection::Collect(changed, timing);
+
+    timing.Scan = chrono::duration_cast<chrono::microseconds>(scan_end - scan_start);
+    timing.ChangedSlots = changed.size();
+
+    // Detach every changed slot from its old member and attach the new ones, remembering which keys were touched.
+    std::unordered_set<uint64_t> touched;
+    for (const int32_t index : changed)
+    {
+        if (index >= watermark || m_Slots[index].Member == NO_MEMBER)
+            continue;
+
+        const uint32_t old_member = m_Slots[index].Member;
+        const uint64_t key = MakeKey(m_Members[old_member].Outer, m_Members[old_member].Name);
+
+        std::vector<int32_t>& owners = m_Owners[key];
+        if (const auto owner = std::ranges::lower_bound(owners, index); owner != owners.end() && *owner == index)
+            owners.erase(owner);
+
+        touched.insert(key);
+        m_FreeMembers.push_back(old_member);
+    }
+
+    for (const ReflectedMember& member : members)
+    {
+        const PackedMember packed{
+            member.Offset, member.ObjectIndex, member.Size, m_Strings.Intern(member.Outer),
+            m_Strings.Intern(member.Name), member.IsFunction
+        };
+
+        uint32_t slot_member;
+        if (!m_FreeMembers.empty())
+        {
+            slot_member = m_FreeMembers.back();
+            m_FreeMembers.pop_back();
+            m_Members[slot_member] = packed;
+        }
+        else
+        {
+            slot_member = static_cast<uint32_t>(m_Members.size());
+            m_Members.push_back(packed);
+        }
+        current[member.ObjectIndex].Member = slot_member;
+
+        const uint64_t key = MakeKey(packed.Outer, packed.Name);
+        std::vector<int32_t>& owners = m_Owners[key];
+        if (owners.empty() && !touched.contains(key))
+            m_OuterNames[packed.Outer].push_back(packed.Name);
+
+        owners.insert(std::ranges::lower_bound(owners, member.ObjectIndex), member.ObjectIndex);
+        touched.insert(key);
+    }
+
+    current.resize(count);
+    m_Slots = std::move(current);
+
+    std::vector<ReflectedChange> changes;
+    changes.reserve(touched.size());
+    for (const uint64_t key : touched)
+    {
+        const auto outer = static_cast<uint32_t>(key >> 32);
+        const auto name = static_cast<uint32_t>(key);
+        ReflectedChange& change = changes.emplace_back(ReflectedChange{outer, name});
+
+        const auto owners = m_Owners.find(key);
+        if (!owners->second.empty())
+        {
+            change.Member = m_Members[m_Slots[owners->second.front()].Member];
+            continue;
+        }
+
+        // The last owner is gone, the name disappears from its outer.
+        m_Owners.erase(owners);
+
+        std::vector<uint32_t>& names = m_OuterNames[outer];
+        std::erase(names, name);
+        if (names.empty())
+            m_OuterNames.erase(outer);
+    }
+
+    return changes;
+}
+
+void ReflectionIndex::Reset()
+{
+    m_Slots.clear();
+    m_Members.clear();
+    m_FreeMembers.clear();
+    m_Owners.clear();
+    m_OuterNames.clear();
+    m_Strings.Clear();
+}
+
+std::vector<PackedMember> ReflectionIndex::Members(const std::string_view outer) const
+{
+    std::vector<PackedMember> result;
+
+    const std::optional<uint32_t>& outer_id = m_Strings.Find(outer);
+    if (!outer_id.has_value())
+        return result;
+
+    const auto names = m_OuterNames.find(outer_id.value());
+    if (names == m_OuterNames.end())
+        return result;
+
+    result.reserve(names->second.size());
+    for (const uint32_t name : names->second)
+    {
+        const std::vector<int32_t>& owners = m_Owners.at(MakeKey(outer_id.value(), name));
+        result.push_back(m_Members[m_Slots[owners.front()].Member]);
+    }
+
+    return result;
+}
+
+std::vector<std::string_view> ReflectionIndex::Outers() const
+{
+    std::vector<std::string_view> result;
+    result.reserve(m_OuterNames.size());
+    for (const uint32_t outer : m_OuterNames | std::views::keys)
+        result.push_back(m_Strings.Get(outer));
+
+    return result;
+}
+
+size_t ReflectionIndex::MemoryUsage() const
+{
+    // Hash nodes hold the key, the value and a next pointer, plus a bucket pointer each.
+    constexpr size_t owner_node = sizeof(uint64_t) + sizeof(std::vector<int32_t>) + 2 * sizeof(void*);
+    constexpr size_t outer_node = sizeof(uint32_t) + sizeof(std::vector<uint32_t>) + 2 * sizeof(void*);
+
+    size_t total = m_Slots.capacity() * sizeof(Slot) + m_Members.capacity() * sizeof(PackedMember) +
+        m_FreeMembers.capacity() * sizeof(uint32_t) + m_Strings.MemoryUsage();
+
+    for (const std::vector<int32_t>& owners : m_Owners | std::views::values)
+        total += owner_node + owners.capacity() * sizeof(int32_t);
+
+    for (const std::vector<uint32_t>& names : m_OuterNames | std::views::values)
+        total += outer_node + names.capacity() * sizeof(uint32_t);
+
+    return total;
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+
+#include <utils/string_pool.h>
+
+#include <span>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief A function or property found in the UObjectArray, as exposed through unreal.Types.
+ */
+struct ReflectedMember
+{
+    int32_t ObjectIndex{0};
+    /** Name of the struct or class declaring the member **/
+    std::string Outer{};
+    std::string Name{};
+    /** Property offset, or the address of the UFunction **/
+    int64_t Offset{0};
+    int32_t Size{0};
+    bool IsFunction{false};
+};
+
+/**
+ * @brief Time spent in each phase of a reflection crawl.
+ */
+struct ReflectionTiming
+{
+    unsigned Threads{0};
+    /** Comparing slots against the previous crawl, only for incremental updates **/
+    chrono::microseconds Scan{0};
+    /** Slots that were new, recycled or destroyed since the previous crawl **/
+    size_t ChangedSlots{0};
+    /** Classifying objects and resolving names, on every thread **/
+    chrono::microseconds Collect{0};
+    /** Joining the per-thread results **/
+    chrono::microseconds Merge{0};
+};
+
+/**
+ * @brief Crawls the UObjectArray for functions and properties.
+ */
+class Reflection final
+{
+public:
+    Reflection() = delete;
+
+    /**
+     * @brief Collect the members among the objects in [begin, end). Blocks of the array are handed out to one thread
+     *        per hardware thread. The caller should be the game thread so that garbage collection can't run while the
+     *        workers read objects.
+     * @return Members in ascending object index order
+     */
+    static std::vector<ReflectedMember> Collect(int32_t begin, int32_t end, ReflectionTiming& timing);
+
+    /**
+     * @brief Same as the range version, for a sorted list of object indices.
+     */
+    static std::vector<ReflectedMember> Collect(std::span<const int32_t> indices, ReflectionTiming& timing);
+};
+
+/**
+ * @brief A member as the reflection index stores it, with its names interned.
+ */
+struct PackedMember
+{
+    int64_t Offset{0};
+    int32_t ObjectIndex{0};
+    int32_t Size{0};
+    uint32_t Outer{0};
+    uint32_t Name{0};
+    bool IsFunction{false};
+};
+
+/**
+ * @brief A change to the visible members, i.e. what unreal.Types.Outer.Name should now be. Names are ids in the
+ *        index's string pool.
+ */
+struct ReflectedChange
+{
+    uint32_t Outer{0};
+    uint32_t Name{0};
+    /** Empty if the member no longer exists **/
+    std::optional<PackedMember> Member{};
+};
+
+/**
+ * @brief Keeps the members of the UObjectArray up to date across crawls.
+ *
+ * Every slot below the watermark remembers the object, SerialNumber and name it was crawled with. An update compares
+ * slots in memory, crawls only the ones that are new, recycled or destroyed and reports only the outer and name pairs
+ * those slots had or have. When several objects share an outer and name, the one with the lowest index is visible,
+ * as with a full crawl.
+ *
+ * Members are stored packed with interned names, so the index can answer for any outer without Lua holding a table
+ * for every one of them.
+ */
+class ReflectionIndex final
+{
+public:
+    /**
+     * @brief Bring the index up to date with the UObjectArray.
+     * @return Changes to the visible members, all of them on the first update
+     */
+    std::vector<ReflectedChange> Update(ReflectionTiming& timing);
+
+    /**
+     * @brief Forget everything, the next update crawls the whole array again.
+     */
+    void Reset();
+
+    /**
+     * @return The highest slot index processed plus one.
+     */
+    int32_t Watermark() const
+    {
+        return static_cast<int32_t>(m_Slots.size());
+    }
+
+    /**
+     * @return The visible members declared by an outer, in no particular order.
+     */
+    std::vector<PackedMember> Members(std::string_view outer) const;
+
+    /**
+     * @return The names of every outer with at least one visible member.
+     */
+    std::vector<std::string_view> Outers() const;
+
+    const StringPool& Strings() const
+    {
+        return m_Strings;
+    }
+
+    /**
+     * @return Approximate bytes allocated for the index.
+     */
+    size_t MemoryUsage() const;
+
+private:
+    static constexpr uint32_t NO_MEMBER = UINT32_MAX;
+
+    struct Slot
+    {
+        UObject* Object{nullptr};
+        int32_t SerialNumber{0};
+        uint64_t Name{0};
+        /** Index into m_Members **/
+        uint32_t Member{NO_MEMBER};
+    };
+
+    static uint64_t MakeKey(const uint32_t outer, const uint32_t name)
+    {
+        return static_cast<uint64_t>(outer) << 32 | name;
+    }
+
+    std::vector<Slot> m_Slots{};
+    std::vector<PackedMember> m_Members{};
+    /** Unused entries of m_Members **/
+    std::vector<uint32_t> m_FreeMembers{};
+    /** Slots sharing an outer and name, ascending. The first one is visible. **/
+    std::unordered_map<uint64_t, std::vector<int32_t>> m_Owners{};
+    /** Names with at least one owner, per outer **/
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_OuterNames{};
+    StringPool m_Strings{};
+};
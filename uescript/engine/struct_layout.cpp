@@ -0,0 +1,166 @@
+#include <uescript.h>
+#include "struct_layout.h"
+#include "engine.h"
+
+#include <bit>
+
+/** Longer chains are assumed to be garbage, real ones are around ten deep **/
+static constexpr size_t MAX_CHAIN_LENGTH = 64;
+/** Same for the number of properties or children of a single struct **/
+static constexpr size_t MAX_CHILDREN = 65536;
+
+static constexpr size_t MIN_SLOTS = 1024;
+
+std::span<const LayoutProperty> StructLayouts::Get(const UStruct* klass)
+{
+    if (klass == nullptr)
+        return {};
+
+    const Layout& layout = GetLayout(klass, 0);
+    return std::span(m_Properties).subspan(layout.First, layout.Count);
+}
+
+const LayoutProperty* StructLayouts::Find(const UStruct* klass, const std::string_view name)
+{
+    if (klass == nullptr)
+        return nullptr;
+
+    const Layout& layout = GetLayout(klass, 0);
+
+    const std::optional<uint32_t>& name_id = m_NameStrings.Find(name);
+    if (!name_id.has_value() || m_Slots.empty())
+        return nullptr;
+
+    const Slot& slot = m_Slots[SlotOf(klass, m_NameValues[name_id.value()])];
+    if (slot.Class == nullptr)
+        return nullptr;
+
+    // Slots of a rebuilt layout may still point into its old range.
+    if (slot.Property < layout.First || slot.Property >= layout.First + layout.Count)
+        return nullptr;
+
+    return &m_Properties[slot.Property];
+}
+
+void StructLayouts::Clear()
+{
+    m_Layouts.clear();
+    m_Properties.clear();
+    m_Slots.clear();
+    m_Used = 0;
+    m_Shift = 64;
+    m_NameStrings.Clear();
+    m_NameValues.clear();
+}
+
+const StructLayouts::Layout& StructLayouts::GetLayout(const UStruct* klass, const size_t depth)
+{
+    const uint64_t name = klass->Super.Super.Name.v.CompositeComparisonValue;
+
+    if (const auto it = m_Layouts.find(klass); it != m_Layouts.end() && it->second.Name == name &&
+        it->second.SuperStruct == klass->SuperStruct && it->second.Children == klass->Children &&
+        it->second.PropertyLink == klass->PropertyLink)
+    {
+        return it->second;
+    }
+
+    Layout layout{name, klass->SuperStruct, klass->Children, klass->PropertyLink};
+    Build(klass, layout, depth);
+    return m_Layouts.insert_or_assign(klass, layout).first->second;
+}
+
+void StructLayouts::Build(const UStruct* klass, Layout& layout, const size_t depth)
+{
+    // Inherited properties come first, as they do in memory.
+    std::vector<LayoutProperty> properties;
+    if (klass->SuperStruct != nullptr && depth < MAX_CHAIN_LENGTH)
+    {
+        const Layout& super_layout = GetLayout(klass->SuperStruct, depth + 1);
+        properties.assign(m_Properties.begin() + super_layout.First,
+                          m_Properties.begin() + super_layout.First + super_layout.Count);
+    }
+
+    const auto& add = [this, klass, &properties](const UProperty* property, const ClassKinds& kinds)
+    {
+        properties.push_back({
+            property, klass, property->Super.Name.v.CompositeComparisonValue, property->Offset_Internal,
+            property->ElementSize, property->ArrayDim, MostDerivedKind(kinds)
+        });
+
+        const std::string_view& name = UE::GetAsciiObjectNameFast(&property->Super, m_NameBuf);
+        if (const uint32_t id = m_NameStrings.Intern(name); id == m_NameValues.size())
+            m_NameValues.push_back(property->Super.Name.v.CompositeComparisonValue);
+    };
+
+    size_t visited = 0;
+    if (klass->PropertyLink != nullptr)
+    {
+        // PropertyLink also holds inherited properties, the ones declared here have this struct as their Outer.
+        for (const UProperty* property = klass->PropertyLink; property != nullptr && visited < MAX_CHILDREN;
+             property = property->PropertyLinkNext)
+        {
+            visited++;
+
+            const ClassKinds& kinds = g_ClassKinds.Get(property->Super.Class);
+            if (property->Super.Outer == &klass->Super.Super && HasKind(kinds, ClassKind::Property))
+                add(property, kinds);
+        }
+    }
+    else
+    {
+        // Not linked yet. Children also holds functions, only properties have a layout.
+        for (const UField* field = klass->Children; field != nullptr && visited < MAX_CHILDREN; field = field->Next)
+        {
+            visited++;
+
+            const ClassKinds& kinds = g_ClassKinds.Get(field->Super.Class);
+            if (HasKind(kinds, ClassKind::Property))
+                add(reinterpret_cast<const UProperty*>(field), kinds);
+        }
+    }
+
+    layout.First = static_cast<uint32_t>(m_Properties.size());
+    layout.Count = static_cast<uint32_t>(properties.size());
+    m_Properties.insert(m_Properties.end(), properties.begin(), properties.end());
+
+    for (uint32_t i = layout.First; i < layout.First + layout.Count; i++)
+        Insert(klass, m_Properties[i].Name, i);
+}
+
+size_t StructLayouts::SlotOf(const UStruct* klass, const uint64_t name) const
+{
+    // Fibonacci hashing of both halves of the key, then linear probing.
+    const uint64_t hash = (reinterpret_cast<uint64_t>(klass) ^ name * 0x9E3779B97F4A7C15) * 0x9E3779B97F4A7C15;
+
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t slot = hash >> m_Shift;; slot = (slot + 1) & mask)
+    {
+        const Slot& current = m_Slots[slot];
+        if (current.Class == nullptr || (current.Class == klass && current.Name == name))
+            return slot;
+    }
+}
+
+void StructLayouts::Insert(const UStruct* klass, const uint64_t name, const uint32_t property)
+{
+    // Keep the table at most half full so probes stay short.
+    if ((m_Used + 1) * 2 > m_Slots.size())
+    {
+        std::vector<Slot> old = std::move(m_Slots);
+        const size_t size = std::max(MIN_SLOTS, old.size() * 2);
+
+        m_Slots.assign(size, Slot{});
+        m_Shift = 64 - std::countr_zero(size);
+        for (const Slot& slot : old)
+        {
+            if (slot.Class != nullptr)
+                m_Slots[SlotOf(slot.Class, slot.Name)] = slot;
+        }
+    }
+
+    Slot& slot = m_Slots[SlotOf(klass, name)];
+    if (slot.Class == nullptr)
+        m_Used++;
+
+    slot = {klass, name, property};
+}
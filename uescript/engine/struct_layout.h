@@ -0,0 +1,90 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+#include "class_kinds.h"
+
+#include <span>
+#include <unordered_map>
+
+#include <utils/string_pool.h>
+
+/**
+ * @brief A property of a struct or class, including the ones it inherits.
+ */
+struct LayoutProperty
+{
+    const UProperty* Property{nullptr};
+    /** Struct declaring the property **/
+    const UStruct* Owner{nullptr};
+    /** FName of the property as its composite comparison value **/
+    uint64_t Name{0};
+    int32_t Offset{0};
+    int32_t ElementSize{0};
+    int32_t ArrayDim{0};
+    ClassKind Kind{ClassKind::Max};
+};
+
+/**
+ * @brief Flattens the properties of structs and classes by walking the PropertyLink of every struct in the SuperStruct
+ *        chain, base first, or its Children if it was not linked yet. Lookups by (struct, name) go through an
+ *        open-addressing table, so finding the offset of a field costs a couple of hash probes no matter which base
+ *        declares it.
+ *
+ * Layouts remember the name, SuperStruct, Children and PropertyLink of the struct they were built from and are rebuilt
+ * when any of them changed, in case the struct was destroyed and its memory reused. Only used from the game thread.
+ */
+class StructLayouts final
+{
+public:
+    /**
+     * @return Every property of a struct in declaration order, base classes first. Empty for a null struct. Only valid
+     *         until another layout is built.
+     */
+    std::span<const LayoutProperty> Get(const UStruct* klass);
+
+    /**
+     * @return The property of a struct or one of its bases with a name, or nullptr.
+     */
+    const LayoutProperty* Find(const UStruct* klass, std::string_view name);
+
+    void Clear();
+
+private:
+    struct Layout
+    {
+        uint64_t Name{0};
+        const UStruct* SuperStruct{nullptr};
+        const UField* Children{nullptr};
+        const UProperty* PropertyLink{nullptr};
+        /** Range in m_Properties **/
+        uint32_t First{0};
+        uint32_t Count{0};
+    };
+
+    struct Slot
+    {
+        /** nullptr for an empty slot **/
+        const UStruct* Class{nullptr};
+        uint64_t Name{0};
+        uint32_t Property{0};
+    };
+
+    const Layout& GetLayout(const UStruct* klass, size_t depth);
+    void Build(const UStruct* klass, Layout& layout, size_t depth);
+
+    size_t SlotOf(const UStruct* klass, uint64_t name) const;
+    void Insert(const UStruct* klass, uint64_t name, uint32_t property);
+
+    std::unordered_map<const UStruct*, Layout> m_Layouts{};
+    /** Layouts are appended, a rebuilt layout leaves its old range unused until Clear **/
+    std::vector<LayoutProperty> m_Properties{};
+    std::vector<Slot> m_Slots{};
+    size_t m_Used{0};
+    int m_Shift{64};
+    /** Property names seen while building, to map the names scripts ask for to FNames **/
+    StringPool m_NameStrings{};
+    std::vector<uint64_t> m_NameValues{};
+    std::array<char, 512> m_NameBuf{};
+};
+
+inline StructLayouts g_StructLayouts;
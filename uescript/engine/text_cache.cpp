@@ -0,0 +1,56 @@
+#include <uescript.h>
+#include "text_cache.h"
+#include "engine.h"
+
+const FString& TextCache::Get(const std::string_view text)
+{
+    return Lookup(text).String;
+}
+
+Vector2 TextCache::Measure(UObject* canvas, void* font, const std::string_view text)
+{
+    constexpr Vector2 scale = {1.f, 1.f};
+
+    Entry& entry = Lookup(text);
+    for (const auto& [size_font, size] : entry.Sizes)
+    {
+        if (size_font == font)
+            return size;
+    }
+
+    uint64_t unk;
+    const Vector2 size = *g_EP.SizeOfText(canvas, &unk, font, entry.String, scale);
+    entry.Sizes.emplace_back(font, size);
+    return size;
+}
+
+void TextCache::Clear()
+{
+    m_Index.clear();
+    m_Entries.clear();
+}
+
+TextCache::Entry& TextCache::Lookup(const std::string_view text)
+{
+    if (const auto it = m_Index.find(text); it != m_Index.end())
+    {
+        m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+        return *it->second;
+    }
+
+    if (m_Entries.size() >= MAX_ENTRIES)
+    {
+        m_Index.erase(m_Entries.back().Text);
+        m_Entries.pop_back();
+    }
+
+    Entry& entry = m_Entries.emplace_front();
+    entry.Text = text;
+    entry.Wide = StringUtl::AsciiToWideString(text);
+    // Count includes the terminator, as the engine's own strings do.
+    const auto count = static_cast<int32_t>(entry.Wide.size() + 1);
+    entry.String = {entry.Wide.c_str(), count, count};
+
+    m_Index.emplace(entry.Text, m_Entries.begin());
+    return entry;
+}
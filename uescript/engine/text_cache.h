@@ -0,0 +1,55 @@
+#pragma once
+#include <uescript.h>
+#include "objects.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Wide copies of the strings drawn by unreal.DrawText and measured by unreal.SizeOfText, so a label drawn
+ *        every frame is converted once. Measurements are remembered per font. The least recently used strings are
+ *        evicted beyond MAX_ENTRIES.
+ */
+class TextCache final
+{
+public:
+    static constexpr size_t MAX_ENTRIES = 4096;
+
+    /**
+     * @return An FString for text. Stays valid until text is evicted, i.e. for at least MAX_ENTRIES - 1 more lookups.
+     */
+    const FString& Get(std::string_view text);
+
+    /**
+     * @return The size of text in a font at unit scale, asking the engine the first time.
+     */
+    Vector2 Measure(UObject* canvas, void* font, std::string_view text);
+
+    size_t Size() const
+    {
+        return m_Entries.size();
+    }
+
+    void Clear();
+
+private:
+    struct Entry
+    {
+        std::string Text{};
+        std::wstring Wide{};
+        FString String{};
+        /** By font, there are only ever a few **/
+        std::vector<std::pair<void*, Vector2>> Sizes{};
+    };
+
+    Entry& Lookup(std::string_view text);
+
+    /** Most recently used first **/
+    std::list<Entry> m_Entries{};
+    /** Keys view the Text of an entry **/
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_Index{};
+};
+
+inline TextCache g_TextCache;
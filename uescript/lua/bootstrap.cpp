@@ -65,6 +65,36 @@ bool LuaBootstrap::Bootstrap() const
     {
         lua_pushcfunction(L, Signature::Find);
         lua_setfield(L, -2, "Find");
+        lua_pushcfunction(L, Signature::FindMany);
+        lua_setfield(L, -2, "FindMany");
+        lua_pushcfunction(L, Signature::FindAll);
+        lua_setfield(L, -2, "FindAll");
+        lua_pushcfunction(L, Signature::Iter);
+        lua_setfield(L, -2, "Iter");
+        lua_pushcfunction(L, Signature::FindInRange);
+        lua_setfield(L, -2, "FindInRange");
+        lua_pushcfunction(L, Signature::FindInSection);
+        lua_setfield(L, -2, "FindInSection");
+        lua_pushcfunction(L, Signature::FindInBuffer);
+        lua_setfield(L, -2, "FindInBuffer");
+        lua_pushcfunction(L, Signature::FindXrefs);
+        lua_setfield(L, -2, "FindXrefs");
+        lua_pushcfunction(L, Signature::FindXrefsMany);
+        lua_setfield(L, -2, "FindXrefsMany");
+        lua_pushcfunction(L, Signature::FindByString);
+        lua_setfield(L, -2, "FindByString");
+        lua_pushcfunction(L, Signature::FunctionAt);
+        lua_setfield(L, -2, "FunctionAt");
+        lua_pushcfunction(L, Signature::FunctionRange);
+        lua_setfield(L, -2, "FunctionRange");
+        lua_pushcfunction(L, Signature::FindInFunction);
+        lua_setfield(L, -2, "FindInFunction");
+        lua_pushcfunction(L, Signature::Generate);
+        lua_setfield(L, -2, "Generate");
+        lua_pushcfunction(L, Signature::EnableIndex);
+        lua_setfield(L, -2, "EnableIndex");
+        lua_pushcfunction(L, Signature::IndexStats);
+        lua_setfield(L, -2, "IndexStats");
         lua_pushcfunction(L, Signature::Rip);
         lua_setfield(L, -2, "Rip");
     }
@@ -140,6 +170,46 @@ assert(process_name == "ExampleGame-Win64-Shipping.exe")
 	To retrieve the required pointers, you may use the signature library:
 		- sig.Find("IDA-style signature")
 		- sig.Find("MyModule.dll", "IDA-style signature")
+		- sig.Find("IDA-style signature", true) scans using every hardware thread
+	
+	Finding many signatures in a single pass over the module (much faster than calling sig.Find for each):
+		- sig.FindMany({ Name = "IDA-style signature", ... })
+		- sig.FindMany("MyModule.dll", { Name = "IDA-style signature", ... })
+		  Returns a table with the same keys. Signatures that were not found are nil.
+	
+	Finding every occurrence of a signature:
+		- sig.FindAll("IDA-style signature", [module], [limit], [parallel]) returns an array of addresses
+		- for address in sig.Iter("IDA-style signature", [module]) do ... end
+	
+	Scanning outside of the module's code:
+		- sig.FindInSection([module], ".rdata", "IDA-style signature")
+		- sig.FindInRange(start_address, length, "IDA-style signature")
+		- sig.FindInBuffer(lua_string, "IDA-style signature", [init]) returns a 1-based index like string.find
+	
+	Finding code that references an address, e.g. a global or a string literal:
+		- sig.FindXrefs(address, [module], [limit]) returns an array of instruction addresses
+		- sig.FindXrefsMany({ address, ... }, [module]) returns a table mapping each address to such an array
+	
+	Finding functions through a string literal they use, which survives game updates better than signatures:
+		- local functions, xrefs = sig.FindByString("StaticFindObject", [module], [encoding])
+		  Searches .rdata for the literal as ASCII and UTF-16 (or only "ascii"/"utf16"). functions holds the start
+		  of each function referencing it.
+	
+	Function boundaries, from the module's exception directory:
+		- sig.FunctionAt(address) returns the start of the function containing address
+		- sig.FunctionRange(address) returns the start and end of that function
+		- sig.FindInFunction(address, "IDA-style signature") scans only that function
+	
+	Generating a signature, e.g. after an update broke one:
+		- sig.Generate(address, [module]) returns the shortest unique signature starting at address, or nil
+	
+	Speeding up many sig.Find calls against the same module:
+		- sig.EnableIndex([module]) indexes the module's code on a background thread, sig.Find scans as usual until
+		  it is ready. The index takes about four times the size of the code in memory.
+		- sig.IndexStats([module]) returns a table with Ready, Memory, BuildTime, Hits, Misses and HitRate
+	
+	Results of sig.Find and sig.FindMany are cached in signatures.cache in the uescript directory and reused until
+	the game is updated.
 	
 	Converting a relative pointer:
 		- sig.Rip(relative_pointer, offset, opcode_size)
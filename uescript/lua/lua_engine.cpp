@@ -3,6 +3,7 @@
 #include "bootstrap.h"
 
 #include "sdk/sdk.h"
+#include <engine/draw_list.h>
 #include <engine/engine.h>
 #include <ShlObj.h>
 
@@ -234,6 +235,10 @@ void LuaEngine::DispatchDrawTransitionCallback(UObject* viewport_client, UObject
             PrintStatus(lock, "uescript:draw_transition", status);
         }
     }
+
+    // Commands queued through unreal.draw, by the callback or since the last frame.
+    if (canvas != nullptr)
+        g_DrawList.Flush(canvas);
 }
 
 void LuaEngine::DispatchProcessEventCallback(UObject* object, UObject* function, void* params,
@@ -9,6 +9,36 @@ void SignatureSDK::InitInternal(lua_State* L)
     {
         lua_pushcfunction(L, Signature::Find);
         lua_setfield(L, -2, "Find");
+        lua_pushcfunction(L, Signature::FindMany);
+        lua_setfield(L, -2, "FindMany");
+        lua_pushcfunction(L, Signature::FindAll);
+        lua_setfield(L, -2, "FindAll");
+        lua_pushcfunction(L, Signature::Iter);
+        lua_setfield(L, -2, "Iter");
+        lua_pushcfunction(L, Signature::FindInRange);
+        lua_setfield(L, -2, "FindInRange");
+        lua_pushcfunction(L, Signature::FindInSection);
+        lua_setfield(L, -2, "FindInSection");
+        lua_pushcfunction(L, Signature::FindInBuffer);
+        lua_setfield(L, -2, "FindInBuffer");
+        lua_pushcfunction(L, Signature::FindXrefs);
+        lua_setfield(L, -2, "FindXrefs");
+        lua_pushcfunction(L, Signature::FindXrefsMany);
+        lua_setfield(L, -2, "FindXrefsMany");
+        lua_pushcfunction(L, Signature::FindByString);
+        lua_setfield(L, -2, "FindByString");
+        lua_pushcfunction(L, Signature::FunctionAt);
+        lua_setfield(L, -2, "FunctionAt");
+        lua_pushcfunction(L, Signature::FunctionRange);
+        lua_setfield(L, -2, "FunctionRange");
+        lua_pushcfunction(L, Signature::FindInFunction);
+        lua_setfield(L, -2, "FindInFunction");
+        lua_pushcfunction(L, Signature::Generate);
+        lua_setfield(L, -2, "Generate");
+        lua_pushcfunction(L, Signature::EnableIndex);
+        lua_setfield(L, -2, "EnableIndex");
+        lua_pushcfunction(L, Signature::IndexStats);
+        lua_setfield(L, -2, "IndexStats");
         lua_pushcfunction(L, Signature::Rip);
         lua_setfield(L, -2, "Rip");
     }
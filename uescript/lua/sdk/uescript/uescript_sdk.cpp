@@ -4,6 +4,153 @@
 #include <lua/lua_engine.h>
 #include <utils/allocations.h>
 
+/**
+ * @brief sdk.mem, memory access through FFI pointer casts. Unlike the C functions in sdk, these are recorded into
+ *        traces, so loops walking memory stay compiled. Receives whether pointers are checked for null, as
+ *        TCheckPtrHot does, and returns the module. The checks stop at null, an unreadable address still faults.
+ */
+constexpr std::string_view SDK_MEM = R"(
+local ffi = require("ffi")
+local checked = ...
+
+local cast = ffi.cast
+local typeof = ffi.typeof
+local tonumber = tonumber
+local error = error
+
+local mem = {}
+
+-- Pointer ctypes are created once, ffi.cast with a string is parsed on every call.
+local ptr_types = {}
+local function ptr_type(type_name)
+    local ptr = ptr_types[type_name]
+    if ptr == nil then
+        ptr = typeof("$ *", typeof(type_name))
+        ptr_types[type_name] = ptr
+    end
+    return ptr
+end
+
+local function check(address, name)
+    if checked and (address == nil or address == 0) then
+        error(name .. ": null pointer", 3)
+    end
+end
+
+-- Typed view of an address, indexed like an array from 0 or by field for structs declared with ffi.cdef.
+function mem.Ptr(type_name, address)
+    check(address, "Ptr")
+    return cast(ptr_type(type_name), address)
+end
+
+-- Address of a pointer view as a number, the form the rest of sdk takes.
+function mem.Address(ptr)
+    return tonumber(cast("uintptr_t", ptr))
+end
+
+local function define(name, type_name, wide)
+    local ptr = ptr_type(type_name)
+
+    -- 64-bit values come back as numbers like sdk.ReadI64, not as boxed cdata.
+    if wide then
+        mem["Read" .. name] = function(address)
+            check(address, "Read" .. name)
+            return tonumber(cast(ptr, address)[0])
+        end
+    else
+        mem["Read" .. name] = function(address)
+            check(address, "Read" .. name)
+            return cast(ptr, address)[0]
+        end
+    end
+
+    mem["Write" .. name] = function(address, value)
+        check(address, "Write" .. name)
+        cast(ptr, address)[0] = value
+    end
+end
+
+define("I8", "int8_t")
+define("U8", "uint8_t")
+define("I16", "int16_t")
+define("U16", "uint16_t")
+define("I32", "int32_t")
+define("U32", "uint32_t")
+define("I64", "int64_t", true)
+define("U64", "uint64_t", true)
+define("Float32", "float")
+define("Float64", "double")
+
+-- sdk.DerefPtr also rejects unreadable pointers when checked, which a trace cannot do, so it is only replaced when
+-- pointers are not checked at all. mem.ReadU64 is the compiled read either way.
+mem.DerefPtr = checked and sdk.DerefPtr or mem.ReadU64
+
+-- Counts trace events while fn runs, to see whether a loop stays compiled. Returns the counts followed by what fn
+-- returned. Traces of fn and the functions nested in it are flushed first so they are recorded again, functions it
+-- only calls keep theirs.
+function mem.TraceStats(fn, ...)
+    if jit == nil or jit.attach == nil then
+        error("TraceStats: the JIT does not report trace events")
+    end
+
+    -- Abort reasons are error codes, jit.vmdef has their messages when it is installed.
+    local has_vmdef, vmdef = pcall(require, "jit.vmdef")
+
+    local stats = { started = 0, completed = 0, aborted = 0, reasons = {} }
+    local function on_trace(what, _, _, _, code, info)
+        if what == "start" then
+            stats.started = stats.started + 1
+        elseif what == "stop" then
+            stats.completed = stats.completed + 1
+        elseif what == "abort" then
+            stats.aborted = stats.aborted + 1
+            local key = tostring(code)
+            if has_vmdef and vmdef.traceerr[code] then
+                key = string.format(vmdef.traceerr[code], info)
+            end
+            stats.reasons[key] = (stats.reasons[key] or 0) + 1
+        end
+    end
+
+    jit.flush(fn, true)
+    jit.attach(on_trace, "trace")
+    local result = { pcall(fn, ...) }
+    jit.attach(on_trace)
+    if not result[1] then
+        error(result[2], 0)
+    end
+    return stats, unpack(result, 2, table.maxn(result))
+end
+
+-- Reads a 32-bit value in a loop through sdk.ReadI32 and through mem.ReadI32, returning the trace stats and the
+-- nanoseconds per read of each.
+function mem.Benchmark(address, iterations)
+    check(address, "Benchmark")
+    iterations = iterations or 1000000
+
+    local function run(read)
+        local sum = 0
+        local start = sdk.CurrentTimeUs()
+        for _ = 1, iterations do
+            sum = sum + read(address)
+        end
+        return (sdk.CurrentTimeUs() - start) * 1000 / iterations, sum
+    end
+
+    -- The loop is in run, so each call flushes and records it again.
+    local c_stats, c_ns = mem.TraceStats(run, sdk.ReadI32)
+    local ffi_stats, ffi_ns = mem.TraceStats(run, mem.ReadI32)
+
+    print(string.format("sdk.ReadI32: %.1f ns per read, %d traces, %d aborts", c_ns, c_stats.completed,
+                        c_stats.aborted))
+    print(string.format("sdk.mem.ReadI32: %.1f ns per read, %d traces, %d aborts", ffi_ns, ffi_stats.completed,
+                        ffi_stats.aborted))
+    return c_stats, ffi_stats, c_ns, ffi_ns
+end
+
+return mem
+)";
+
 void UEScriptSDK::InitInternal(lua_State* L)
 {
     lua_newtable(L);
@@ -56,6 +203,35 @@ void UEScriptSDK::InitInternal(lua_State* L)
         lua_setfield(L, -2, "ResetLuaEngine");
     }
     lua_setglobal(L, "sdk");
+
+    InitMemoryModule(L);
+}
+
+void UEScriptSDK::InitMemoryModule(lua_State* L)
+{
+    if (luaL_loadbuffer(L, SDK_MEM.data(), SDK_MEM.size(), "uescript:mem") != LUA_OK)
+    {
+        std::cout << "Failed to load sdk.mem: " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return;
+    }
+
+#ifdef SCRIPT_SAFETY_ON
+    lua_pushboolean(L, true);
+#else
+    lua_pushboolean(L, false);
+#endif
+    if (lua_pcall(L, 1, 1, 0) != LUA_OK)
+    {
+        std::cout << "Failed to initialize sdk.mem: " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return;
+    }
+
+    lua_getglobal(L, "sdk");
+    lua_insert(L, -2);
+    lua_setfield(L, -2, "mem");
+    lua_pop(L, 1);
 }
 
 int UEScriptSDK::LoadString(lua_State* L)
@@ -14,6 +14,12 @@ protected:
     void InitInternal(lua_State* L) override;
 
 private:
+    /**
+     * @brief Set sdk.mem, the FFI counterpart of the Read and Write functions below. Its accessors are compiled into
+     *        traces instead of calling out of them, and follow SCRIPT_SAFETY_ON for null checks.
+     */
+    static void InitMemoryModule(lua_State* L);
+
     // ReSharper disable CppCStyleCast
 
     template <typename T>
@@ -1,8 +1,17 @@
 #include <uescript.h>
 #include "unreal_sdk.h"
 
+#include <engine/class_kinds.h>
+#include <engine/draw_list.h>
 #include <engine/engine.h>
+#include <engine/ffi_cdef.h>
+#include <engine/object_index.h>
+#include <engine/reflection.h>
+#include <engine/struct_layout.h>
+#include <engine/text_cache.h>
 #include <lua/lua_engine.h>
+#include <utils/pe_image.h>
+#include <utils/reflection_snapshot.h>
 
 void UnrealSDK::InitInternal(lua_State* L)
 {
@@ -68,6 +77,12 @@ void UnrealSDK::InitInternal(lua_State* L)
         lua_pushcfunction(L, UnrealSDK::SizeOfText);
         lua_setfield(L, -2, "SizeOfText");
 
+        lua_pushcfunction(L, UnrealSDK::FindObject);
+        lua_setfield(L, -2, "FindObject");
+
+        lua_pushcfunction(L, UnrealSDK::FindObjects);
+        lua_setfield(L, -2, "FindObjects");
+
         lua_pushcfunction(L, UnrealSDK::FindObjectSlow);
         lua_setfield(L, -2, "FindObjectSlow");
 
@@ -88,6 +103,24 @@ void UnrealSDK::InitInternal(lua_State* L)
 
             lua_pushcfunction(L, (WrapField<UObject, &UObject::InternalIndex>));
             lua_setfield(L, -2, "GetObjectInternalIndex");
+
+            lua_pushcfunction(L, UnrealSDK::IsA);
+            lua_setfield(L, -2, "IsA");
+
+            lua_pushcfunction(L, UnrealSDK::OffsetOf);
+            lua_setfield(L, -2, "OffsetOf");
+
+            lua_pushcfunction(L, UnrealSDK::GetProperties);
+            lua_setfield(L, -2, "GetProperties");
+
+            lua_pushcfunction(L, UnrealSDK::GenerateCdef);
+            lua_setfield(L, -2, "GenerateCdef");
+
+            lua_pushcfunction(L, UnrealSDK::DefineFFI);
+            lua_setfield(L, -2, "DefineFFI");
+
+            lua_pushcfunction(L, UnrealSDK::BenchmarkFFI);
+            lua_setfield(L, -2, "BenchmarkFFI");
         }
 
         lua_pushcfunction(L, UnrealSDK::GetAllActorsOfClass);
@@ -100,134 +133,336 @@ void UnrealSDK::InitInternal(lua_State* L)
         lua_setfield(L, -2, "FNameToString");
 
         lua_pushcfunction(L, [](lua_State *L)
-                          { UnrealSDK::GenerateUnrealTypes(L); return 0; });
+                          { UnrealSDK::GenerateUnrealTypes(L, lua_toboolean(L, 1)); return 0; });
         lua_setfield(L, -2, "RegenerateTypes");
+
+        lua_pushcfunction(L, UnrealSDK::GetTypeNames);
+        lua_setfield(L, -2, "GetTypeNames");
     }
     lua_setglobal(L, "unreal");
 
-    GenerateUnrealTypes(L);
+    InitEngineFFI(L);
+    InitDrawList(L);
+    LoadUnrealTypes(L);
 }
 
-void UnrealSDK::GenerateUnrealTypes(lua_State* L)
+constexpr const char* REFLECTION_SNAPSHOT_FILE = "reflection.snapshot";
+
+/** Remembers what unreal.Types was built from so regenerating only has to look at what changed **/
+static ReflectionIndex s_ReflectionIndex{};
+/** Reflection data saved by a previous session for this build of the game, used until the next crawl **/
+static std::optional<ReflectionSnapshot> s_Snapshot{};
+
+static std::optional<ModuleIdentity> GetGameIdentity()
 {
-    const auto& then = chrono::system_clock::now();
+    const std::optional<PEImage>& image = PEImage::FromLoaded(
+        reinterpret_cast<const uint8_t*>(GetModuleHandleA(nullptr)));
+    if (!image.has_value())
+        return {};
 
-    const StackGuard outer_guard(L);
+    return ModuleIdentity::FromImage(stdfs::path(UEScript::GetProcessName()).string(), image.value());
+}
 
-    lua_getglobal(L, "unreal");
-    lua_getfield(L, -1, "Types");
-    if (!lua_istable(L, -1))
+/**
+ * @brief Write the reflection index to the home directory for the next session.
+ */
+static void SaveSnapshot()
+{
+    const std::optional<ModuleIdentity>& identity = GetGameIdentity();
+    if (!identity.has_value())
+        return;
+
+    ReflectionSnapshotWriter writer{};
+    for (const std::string_view outer : s_ReflectionIndex.Outers())
     {
-        lua_pop(L, 1);
-        lua_newtable(L);
+        for (const PackedMember& member : s_ReflectionIndex.Members(outer))
+        {
+            const std::string_view& name = s_ReflectionIndex.Strings().Get(member.Name);
+            if (member.IsFunction)
+                writer.AddFunction(outer, name, member.ObjectIndex);
+            else
+                writer.AddProperty(outer, name, static_cast<int32_t>(member.Offset), member.Size);
+        }
     }
 
-    std::array<char, 512> name_buf{};
-    std::array<char, 512> outer_name_buf{};
-    std::array<char, 512> class_name_buf{};
+    if (!writer.Save(LuaEngine::GetHomeDirectory() / REFLECTION_SNAPSHOT_FILE, identity.value()))
+        std::cout << "Failed to write " << REFLECTION_SNAPSHOT_FILE << std::endl;
+}
+
+/**
+ * @brief Find a function recorded in the snapshot. It is usually still at the same index in the UObjectArray, the
+ *        name index is only asked when it is not.
+ */
+static UObject* ResolveSnapshotFunction(const std::string_view outer, const std::string_view name,
+                                        const int32_t object_index)
+{
+    const auto& matches = [outer, name](const UObject* object)
+    {
+        if (object == nullptr || object->Outer == nullptr ||
+            !HasKind(g_ClassKinds.Get(object->Class), ClassKind::Function))
+        {
+            return false;
+        }
+
+        return UE::GetAsciiObjectNameFast(object, conv_buf::g_AsciiBuf) == name &&
+            UE::GetAsciiObjectNameFast(object->Outer, conv_buf::g_AsciiBuf) == outer;
+    };
 
     const UObjectArray* array = g_EP.UObjectArray;
-    for (int32_t index = 0; index < array->NumElements; index++)
+    if (object_index >= 0 && object_index < array->NumElements)
     {
-        const FUObjectItem* item = array->GetObject(index);
-        if (item == nullptr || item->Object == nullptr)
-            continue;
+        if (const FUObjectItem* item = array->GetObject(object_index); item != nullptr && matches(item->Object))
+            return item->Object;
+    }
 
-        UObject* object = item->Object;
-        if (object == nullptr || object->Outer == nullptr || object->Class == nullptr)
-            continue;
+    for (UObject* object : g_ObjectIndex.FindAll(name, ObjectIndex::Match::Exact))
+    {
+        if (matches(object))
+            return object;
+    }
 
-        const std::string_view& class_name = UE::GetAsciiObjectNameFast(object->Class, class_name_buf);
+    return nullptr;
+}
 
-        const bool is_function = class_name.find("Function") != std::string::npos;
-        bool is_property = class_name.find("Property") != std::string::npos;
+static void PushMember(lua_State* L, const int64_t offset, const int32_t size, const bool is_function)
+{
+    lua_createtable(L, 0, 3);
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(offset));
+        lua_setfield(L, -2, "offset");
 
-        // Kind of a gross solution but it's not that slow and it works.
-        if (!is_property)
-        {
-            const UObject* cur = object;
-            while (cur && cur != cur->Class)
-            {
-                const UEStr& w_name = UE::GetObjectName(cur);
-                if (w_name.view().find(L"Property") != std::wstring_view::npos)
-                {
-                    is_property = true;
-                    break;
-                }
-
-                cur = cur->Class;
-            }
-        }
+        lua_pushinteger(L, size);
+        lua_setfield(L, -2, "size");
 
-        if (!is_function && !is_property)
-            continue;
+        lua_pushboolean(L, is_function);
+        lua_setfield(L, -2, "is_function");
+    }
+}
 
-        const std::string_view& outer_name = UE::GetAsciiObjectNameFast(object->Outer, outer_name_buf);
-        const std::string_view& name = UE::GetAsciiObjectNameFast(object, name_buf);
+static void PushMember(lua_State* L, const PackedMember& member)
+{
+    PushMember(L, member.Offset, member.Size, member.IsFunction);
+}
 
-        const StackGuard guard(L);
+void UnrealSDK::PushTypesProxy(lua_State* L)
+{
+    lua_newtable(L);
+    lua_createtable(L, 0, 1);
+    {
+        lua_pushcfunction(L, UnrealSDK::IndexTypes);
+        lua_setfield(L, -2, "__index");
+    }
+    lua_setmetatable(L, -2);
+}
 
-        lua_getfield(L, -1, outer_name.data());
+/**
+ * @brief Push the table for an outer as read from the snapshot, or nil if it has none.
+ */
+static void PushSnapshotClass(lua_State* L, const std::string_view outer)
+{
+    const SnapshotClass* klass = s_Snapshot->FindClass(outer);
+    if (klass == nullptr)
+    {
+        lua_pushnil(L);
+        return;
+    }
 
-        // Does outer_name not exist in the table? Create it and push it onto the stack.
-        if (lua_type(L, -1) == LUA_TNIL)
+    const std::span<const SnapshotProperty>& properties = s_Snapshot->Properties(*klass);
+    const std::span<const SnapshotFunction>& functions = s_Snapshot->Functions(*klass);
+
+    lua_createtable(L, 0, static_cast<int>(properties.size() + functions.size()));
+    for (const SnapshotProperty& property : properties)
+    {
+        PushMember(L, property.Offset, property.Size, false);
+        lua_setfield(L, -2, s_Snapshot->String(property.Name).data());
+    }
+
+    for (const SnapshotFunction& function : functions)
+    {
+        const std::string_view& name = s_Snapshot->String(function.Name);
+        if (UObject* object = ResolveSnapshotFunction(outer, name, function.ObjectIndex); object != nullptr)
         {
-            lua_pop(L, 1);
-            lua_newtable(L);
-            // We need the table to still be on the stack
-            lua_pushvalue(L, -1);
-            lua_setfield(L, -3, outer_name.data());
+            PushMember(L, reinterpret_cast<int64_t>(object), 0, true);
+            lua_setfield(L, -2, name.data());
         }
+    }
+}
+
+void UnrealSDK::LoadUnrealTypes(lua_State* L)
+{
+    const auto& then = chrono::steady_clock::now();
+
+    // A crawl in this process is more recent than any snapshot.
+    if (!s_Snapshot.has_value() && s_ReflectionIndex.Watermark() == 0)
+    {
+        if (const std::optional<ModuleIdentity>& identity = GetGameIdentity(); identity.has_value())
+            s_Snapshot = ReflectionSnapshot::Open(LuaEngine::GetHomeDirectory() / REFLECTION_SNAPSHOT_FILE,
+                                                  identity.value());
+    }
+
+    if (!s_Snapshot.has_value())
+    {
+        GenerateUnrealTypes(L);
+        return;
+    }
+
+    const StackGuard guard(L);
+
+    lua_getglobal(L, "unreal");
+    PushTypesProxy(L);
+    lua_setfield(L, -2, "Types");
+
+    const auto& now = chrono::steady_clock::now();
+    std::cout << std::format("Loaded Unreal types from {} in {:.1f} ms ({} classes, {} KB)",
+                             REFLECTION_SNAPSHOT_FILE,
+                             chrono::duration_cast<chrono::duration<double, std::milli>>(now - then).count(),
+                             s_Snapshot->Classes().size(), s_Snapshot->Size() / 1024) << std::endl;
+}
+
+int UnrealSDK::IndexTypes(lua_State* L)
+{
+    // Only reached for outers that were never looked up, the table is cached in unreal.Types afterwards.
+    if (lua_type(L, 2) != LUA_TSTRING)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    size_t length = 0;
+    const char* outer = lua_tolstring(L, 2, &length);
+
+    if (s_Snapshot.has_value())
+    {
+        PushSnapshotClass(L, {outer, length});
+        if (lua_isnil(L, -1))
+            return 1;
+
+        lua_pushvalue(L, 2);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, 1);
+        return 1;
+    }
+
+    const std::vector<PackedMember>& members = s_ReflectionIndex.Members({outer, length});
+    if (members.empty())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, 0, static_cast<int>(members.size()));
+    for (const PackedMember& member : members)
+    {
+        PushMember(L, member);
+        lua_setfield(L, -2, s_ReflectionIndex.Strings().Get(member.Name).data());
+    }
 
-        // Skip if there's already an object in the table.
+    lua_pushvalue(L, 2);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, 1);
+    return 1;
+}
+
+int UnrealSDK::GetTypeNames(lua_State* L)
+{
+    if (s_Snapshot.has_value())
+    {
+        const std::span<const SnapshotClass>& classes = s_Snapshot->Classes();
+
+        lua_createtable(L, static_cast<int>(classes.size()), 0);
+        for (size_t i = 0; i < classes.size(); i++)
         {
-            lua_getfield(L, -1, name.data());
-            const bool already_exists = lua_type(L, -1) != LUA_TNIL;
-            lua_pop(L, 1);
-            if (already_exists)
-                continue;
+            lua_pushstring(L, s_Snapshot->String(classes[i].Name).data());
+            lua_rawseti(L, -2, static_cast<int>(i + 1));
         }
 
-        if (is_function)
-        {
-            lua_newtable(L);
-            {
-                lua_pushinteger(L, reinterpret_cast<lua_Integer>(object));
-                lua_setfield(L, -2, "offset");
+        return 1;
+    }
 
-                lua_pushinteger(L, 0);
-                lua_setfield(L, -2, "size");
+    const std::vector<std::string_view>& outers = s_ReflectionIndex.Outers();
 
-                lua_pushboolean(L, true);
-                lua_setfield(L, -2, "is_function");
-            }
-            lua_setfield(L, -2, name.data());
-            continue;
-        }
+    lua_createtable(L, static_cast<int>(outers.size()), 0);
+    for (size_t i = 0; i < outers.size(); i++)
+    {
+        lua_pushlstring(L, outers[i].data(), outers[i].size());
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
 
-        const UProperty* prop = reinterpret_cast<UProperty*>(object);
+    return 1;
+}
 
-        if (prop->ElementSize == 0)
-            continue;
+void UnrealSDK::GenerateUnrealTypes(lua_State* L, const bool full)
+{
+    const auto& then = chrono::steady_clock::now();
+    const int heap_before = lua_gc(L, LUA_GCCOUNT, 0);
 
-        lua_newtable(L);
-        {
-            lua_pushinteger(L, prop->Offset_Internal);
-            lua_setfield(L, -2, "offset");
+    const StackGuard outer_guard(L);
 
-            lua_pushinteger(L, prop->ElementSize);
-            lua_setfield(L, -2, "size");
+    // Tables read from the snapshot may hold classes that are not loaded in this session.
+    const bool from_snapshot = s_Snapshot.has_value();
+    s_Snapshot.reset();
 
-            lua_pushboolean(L, false);
-            lua_setfield(L, -2, "is_function");
-        }
-        lua_setfield(L, -2, name.data());
+    lua_getglobal(L, "unreal");
+    lua_getfield(L, -1, "Types");
+    if (full || from_snapshot || !lua_istable(L, -1))
+    {
+        // A new proxy (or a new Lua state) has none of the previous results.
+        lua_pop(L, 1);
+        PushTypesProxy(L);
+        s_ReflectionIndex.Reset();
+    }
+
+    // Lookups only index new slots and a window of old ones, catch up while the array is being walked anyway.
+    g_ObjectIndex.Sync();
+
+    // Only engine memory is read until the changes are applied to the table.
+    ReflectionTiming timing{};
+    const std::vector<ReflectedChange>& changes = s_ReflectionIndex.Update(timing);
+
+    const auto& lua_start = chrono::steady_clock::now();
+
+    // Outers that were never looked up are built from the index on first access, only cached ones need updating.
+    size_t applied = 0;
+    for (const ReflectedChange& change : changes)
+    {
+        const StackGuard guard(L);
+
+        const std::string_view& outer = s_ReflectionIndex.Strings().Get(change.Outer);
+        lua_pushlstring(L, outer.data(), outer.size());
+        lua_rawget(L, -2);
+        if (!lua_istable(L, -1))
+            continue;
+
+        if (change.Member.has_value())
+            PushMember(L, change.Member.value());
+        else
+            lua_pushnil(L);
+
+        lua_setfield(L, -2, s_ReflectionIndex.Strings().Get(change.Name).data());
+        applied++;
     }
 
     lua_setfield(L, -2, "Types");
 
-    const auto& delta = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - then);
-    std::cout << "Generated Unreal types in " << delta.count() << " ms" << std::endl;
+    const auto& snapshot_start = chrono::steady_clock::now();
+    if (!changes.empty())
+        SaveSnapshot();
+
+    const auto& now = chrono::steady_clock::now();
+    const auto& to_ms = [](const auto duration)
+    {
+        return chrono::duration_cast<chrono::duration<double, std::milli>>(duration).count();
+    };
+
+    std::cout << std::format("Generated Unreal types in {:.1f} ms (scan {:.1f} ms, {} changed slots up to {}, "
+                             "collect {:.1f} ms on {} threads, merge {:.1f} ms, Lua {:.1f} ms, {} changes, "
+                             "{} applied to cached types, index {} KB, Lua heap {:+} KB, snapshot {:.1f} ms)",
+                             to_ms(now - then), to_ms(timing.Scan), timing.ChangedSlots,
+                             s_ReflectionIndex.Watermark(), to_ms(timing.Collect), timing.Threads,
+                             to_ms(timing.Merge), to_ms(snapshot_start - lua_start), changes.size(), applied,
+                             s_ReflectionIndex.MemoryUsage() / 1024, lua_gc(L, LUA_GCCOUNT, 0) - heap_before,
+                             to_ms(now - snapshot_start))
+        << std::endl;
 }
 
 int UnrealSDK::WorldToScreen(lua_State* L)
@@ -254,20 +489,12 @@ int UnrealSDK::WorldToScreen(lua_State* L)
 
 int UnrealSDK::DrawText(lua_State* L)
 {
-    // Defaults, maybe DrawTextEx?
-    constexpr Vector2 scale = {1.f, 1.f};
-    constexpr float kerning = 1.f;
-    constexpr FLinearColor shadow_color = FLinearColor::FromRGBA(0, 0, 0, 255);
-    constexpr Vector2 shadow_offset = {1.f, 1.f};
-    constexpr bool center_x = false;
-    constexpr bool center_y = false;
-    constexpr FLinearColor outline_color = shadow_color;
-
     const auto canvas = reinterpret_cast<UObject*>(luaL_checkinteger(L, -10));
     TCheckPtrHot(canvas);
 
     const auto font = reinterpret_cast<void*>(luaL_checkinteger(L, -9));
-    const char* text = luaL_checkstring(L, -8);
+    size_t length = 0;
+    const char* text = luaL_checklstring(L, -8, &length);
 
     const float x = static_cast<float>(luaL_checknumber(L, -7));
     const float y = static_cast<float>(luaL_checknumber(L, -6));
@@ -280,26 +507,8 @@ int UnrealSDK::DrawText(lua_State* L)
     luaL_checktype(L, -1, LUA_TBOOLEAN);
     const bool outlined = lua_toboolean(L, -1);
 
-    const std::wstring_view& w_text = StringUtl::AsciiToWideStringFast(text, conv_buf::g_WideBuf);
-
-    const FString str{
-        w_text.data(), static_cast<int32_t>(w_text.size() + 1), static_cast<int32_t>(w_text.size() + 1)
-    };
-
-    g_EP.DrawText(canvas,
-                  font,
-                  str,
-                  Vector2{x, y},
-                  scale,
-                  FLinearColor::FromRGBA(r, g, b, a),
-                  kerning,
-                  shadow_color,
-                  shadow_offset,
-                  center_x,
-                  center_y,
-                  outlined,
-                  outline_color);
-
+    UE::DrawText(canvas, font, g_TextCache.Get({text, length}), Vector2{x, y}, FLinearColor::FromRGBA(r, g, b, a),
+                 outlined);
     return 0;
 }
 
@@ -335,14 +544,7 @@ int UnrealSDK::DrawRect(lua_State* L)
     const int b = static_cast<int>(luaL_checknumber(L, -2));
     const int a = static_cast<int>(luaL_checknumber(L, -1));
 
-    const Vector2 pos{x, y};
-    const Vector2 size{size_x, size_y};
-    const auto color = FLinearColor::FromRGBA(r, g, b, a);
-
-    g_EP.DrawLine(canvas, pos, Vector2{pos.X + size.X, pos.Y}, thickness, color);
-    g_EP.DrawLine(canvas, pos, Vector2{pos.X, pos.Y + size.Y}, thickness, color);
-    g_EP.DrawLine(canvas, Vector2{pos.X, pos.Y + size.Y}, Vector2{pos.X + size.X, pos.Y + size.Y}, thickness, color);
-    g_EP.DrawLine(canvas, Vector2{pos.X + size.X, pos.Y}, Vector2{pos.X + size.X, pos.Y + size.Y}, thickness, color);
+    UE::DrawRect(canvas, Vector2{x, y}, Vector2{size_x, size_y}, thickness, FLinearColor::FromRGBA(r, g, b, a));
 
     return 0;
 }
@@ -364,34 +566,23 @@ int UnrealSDK::DrawFilledRect(lua_State* L)
     const int b = static_cast<int>(luaL_checknumber(L, -2));
     const int a = static_cast<int>(luaL_checknumber(L, -1));
 
-    // FIXME
-    const auto hud_canvas = reinterpret_cast<UObject**>(reinterpret_cast<uint64_t>(hud) + 0x378);
-    UObject* old_canvas = *hud_canvas;
-
-    *hud_canvas = canvas;
-    g_EP.DrawFilledRect(hud, FLinearColor::FromRGBA(r, g, b, a), x, y, w, h);
-    *hud_canvas = old_canvas;
+    UE::DrawFilledRect(canvas, hud, x, y, w, h, FLinearColor::FromRGBA(r, g, b, a));
     return 0;
 }
 
 int UnrealSDK::SizeOfText(lua_State* L)
 {
-    constexpr Vector2 scale = {1.f, 1.f};
-
     const auto canvas = reinterpret_cast<UObject*>(luaL_checkinteger(L, -3));
     TCheckPtrHot(canvas);
 
     const auto font = reinterpret_cast<void*>(luaL_checkinteger(L, -2));
-    const char* text = luaL_checkstring(L, -1);
-
-    const std::wstring_view w_text = StringUtl::AsciiToWideStringFast(text, conv_buf::g_WideBuf);
-    const FString str{w_text.data(), static_cast<int32_t>(w_text.size() + 1), static_cast<int32_t>(w_text.size() + 1)};
+    size_t length = 0;
+    const char* text = luaL_checklstring(L, -1, &length);
 
-    uint64_t unk;
-    const auto text_size = g_EP.SizeOfText(canvas, &unk, font, str, scale);
+    const Vector2& text_size = g_TextCache.Measure(canvas, font, {text, length});
 
-    lua_pushnumber(L, static_cast<lua_Number>(text_size->X));
-    lua_pushnumber(L, static_cast<lua_Number>(text_size->Y));
+    lua_pushnumber(L, static_cast<lua_Number>(text_size.X));
+    lua_pushnumber(L, static_cast<lua_Number>(text_size.Y));
     return 2;
 }
 
@@ -405,61 +596,57 @@ int UnrealSDK::StaticFindObject(lua_State* L)
     return 1;
 }
 
-int UnrealSDK::FindObjectSlow(lua_State* L)
+static void PushObjects(lua_State* L, const std::vector<UObject*>& objects)
 {
-    const char* search = luaL_checkstring(L, -1);
-
-    const UObjectArray* array = g_EP.UObjectArray;
-    for (int32_t index = 0; index < array->NumElements; index++)
+    lua_createtable(L, static_cast<int>(objects.size()), 0);
+    for (size_t i = 0; i < objects.size(); i++)
     {
-        const FUObjectItem* item = array->GetObject(index);
-        if (item == nullptr || item->Object == nullptr)
-            continue;
-
-        UObject* object = item->Object;
-        if (object == nullptr)
-            continue;
-
-        const std::string_view& name = UE::GetAsciiObjectNameFast(object, conv_buf::g_AsciiBuf);
-        if (name.find(search) != std::string::npos)
-        {
-            lua_pushinteger(L, reinterpret_cast<lua_Integer>(object));
-            return 1;
-        }
+        lua_pushinteger(L, reinterpret_cast<lua_Integer>(objects[i]));
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
     }
+}
 
-    lua_pushnil(L);
+int UnrealSDK::FindObject(lua_State* L)
+{
+    const char* name = luaL_checkstring(L, 1);
+
+    UObject* object = g_ObjectIndex.Find(name);
+    object != nullptr ? lua_pushinteger(L, reinterpret_cast<lua_Integer>(object)) : lua_pushnil(L);
     return 1;
 }
 
-int UnrealSDK::FindAllObjectsSlow(lua_State* L)
+int UnrealSDK::FindObjects(lua_State* L)
 {
-    StringUtl::AsciiToWideStringFast(luaL_checkstring(L, -1), conv_buf::g_WideBuf);
+    static constexpr const char* match_names[] = {"exact", "prefix", "substring", nullptr};
+    static constexpr ObjectIndex::Match matches[] = {
+        ObjectIndex::Match::Exact, ObjectIndex::Match::Prefix, ObjectIndex::Match::Substring
+    };
 
-    lua_newtable(L);
-    int i = 1;
+    const char* query = luaL_checkstring(L, 1);
+    const int match = luaL_checkoption(L, 2, "exact", match_names);
+    const lua_Integer limit = luaL_optinteger(L, 3, 0);
 
-    const UObjectArray* array = g_EP.UObjectArray;
-    for (int32_t index = 0; index < array->NumElements; index++)
-    {
-        const FUObjectItem* item = array->GetObject(index);
-        if (item == nullptr || item->Object == nullptr)
-            continue;
+    if (limit < 0)
+        return luaL_argerror(L, 3, "limit must not be negative");
 
-        UObject* object = item->Object;
-        if (object == nullptr)
-            continue;
+    PushObjects(L, g_ObjectIndex.FindAll(query, matches[match], static_cast<size_t>(limit)));
+    return 1;
+}
 
-        const UEStr& object_name = UE::GetObjectName(object);
-        if (object_name.view().find(conv_buf::g_WideBuf.data()) != std::wstring::npos)
-        {
-            lua_pushnumber(L, i);
-            lua_pushinteger(L, reinterpret_cast<lua_Integer>(object));
-            lua_settable(L, -3);
-            i++;
-        }
-    }
+int UnrealSDK::FindObjectSlow(lua_State* L)
+{
+    const char* search = luaL_checkstring(L, -1);
+
+    const std::vector<UObject*>& objects = g_ObjectIndex.FindAll(search, ObjectIndex::Match::Substring, 1);
+    !objects.empty() ? lua_pushinteger(L, reinterpret_cast<lua_Integer>(objects.front())) : lua_pushnil(L);
+    return 1;
+}
+
+int UnrealSDK::FindAllObjectsSlow(lua_State* L)
+{
+    const char* search = luaL_checkstring(L, -1);
 
+    PushObjects(L, g_ObjectIndex.FindAll(search, ObjectIndex::Match::Substring));
     return 1;
 }
 
@@ -501,6 +688,13 @@ int UnrealSDK::FNameToString(lua_State* L)
     const FName* name = reinterpret_cast<FName*>(luaL_checkinteger(L, -1));
     TCheckPtrHot(name);
 
+    if (const std::optional<std::string_view>& native_name = g_NameTable.ToAscii(
+        *name, conv_buf::g_AsciiBuf.data(), conv_buf::g_AsciiBuf.size()); native_name.has_value())
+    {
+        lua_pushlstring(L, native_name->data(), native_name->size());
+        return 1;
+    }
+
     const UEStr& string = UE::FNameToString(name);
     const std::string_view& cvt_name = StringUtl::WideToAsciiStringFast(string, conv_buf::g_AsciiBuf);
     lua_pushstring(L, cvt_name.data());
@@ -534,3 +728,726 @@ int UnrealSDK::GetObjectName(lua_State* L)
     lua_pushstring(L, name.data());
     return 1;
 }
+
+int UnrealSDK::IsA(lua_State* L)
+{
+    const UObject* object = reinterpret_cast<UObject*>(luaL_checkinteger(L, -2));
+    TCheckPtrHot(object);
+
+    const UObject* klass = reinterpret_cast<UObject*>(luaL_checkinteger(L, -1));
+    TCheckPtrHot(klass);
+
+    lua_pushboolean(L, g_ClassKinds.IsA(object, klass));
+    return 1;
+}
+
+int UnrealSDK::OffsetOf(lua_State* L)
+{
+    const auto klass = reinterpret_cast<const UStruct*>(luaL_checkinteger(L, -2));
+    TCheckPtrHot(klass);
+
+    size_t length = 0;
+    const char* name = luaL_checklstring(L, -1, &length);
+
+    const LayoutProperty* property = g_StructLayouts.Find(klass, {name, length});
+    property != nullptr ? lua_pushinteger(L, property->Offset) : lua_pushnil(L);
+    return 1;
+}
+
+int UnrealSDK::GetProperties(lua_State* L)
+{
+    const auto klass = reinterpret_cast<const UStruct*>(luaL_checkinteger(L, -1));
+    TCheckPtrHot(klass);
+
+    const std::span<const LayoutProperty>& properties = g_StructLayouts.Get(klass);
+
+    lua_createtable(L, static_cast<int>(properties.size()), 0);
+    for (size_t i = 0; i < properties.size(); i++)
+    {
+        const LayoutProperty& property = properties[i];
+
+        lua_createtable(L, 0, 7);
+        {
+            const std::string_view& name = UE::GetAsciiObjectNameFast(&property.Property->Super,
+                                                                      conv_buf::g_AsciiBuf);
+            lua_pushlstring(L, name.data(), name.size());
+            lua_setfield(L, -2, "name");
+
+            lua_pushinteger(L, property.Offset);
+            lua_setfield(L, -2, "offset");
+
+            lua_pushinteger(L, property.ElementSize);
+            lua_setfield(L, -2, "size");
+
+            lua_pushinteger(L, property.ArrayDim);
+            lua_setfield(L, -2, "array_dim");
+
+            const std::string_view& kind = ClassKindName(property.Kind);
+            lua_pushlstring(L, kind.data(), kind.size());
+            lua_setfield(L, -2, "kind");
+
+            lua_pushinteger(L, reinterpret_cast<lua_Integer>(property.Property));
+            lua_setfield(L, -2, "property");
+
+            lua_pushinteger(L, reinterpret_cast<lua_Integer>(property.Owner));
+            lua_setfield(L, -2, "owner");
+        }
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
+
+    return 1;
+}
+
+/** Registry key of the types passed to ffi.cdef by unreal.DefineFFI **/
+constexpr const char* FFI_TYPES_KEY = "uescript.ffi_types";
+
+/**
+ * @brief Reads the same field once through the sdk.Read function of its type and once through a pointer cast to the
+ *        generated type.
+ */
+constexpr std::string_view FFI_BENCHMARK = R"(
+local ffi = require("ffi")
+local object, type_name, field, offset, iterations, reader = ...
+
+local address = object + offset
+local read = sdk[reader]
+local sum = 0
+local start = sdk.CurrentTimeUs()
+for _ = 1, iterations do
+    sum = sum + read(address)
+end
+local read_us = sdk.CurrentTimeUs() - start
+
+local typed = ffi.cast(type_name .. "*", object)
+local value = typed[field]
+-- 64-bit fields are boxed, they add to numbers all the same.
+if type(value) ~= "number" and not (type(value) == "cdata" and ffi.sizeof(value) == 8) then
+    error(field .. " is not a number")
+end
+
+start = sdk.CurrentTimeUs()
+for _ = 1, iterations do
+    sum = sum + typed[field]
+end
+local ffi_us = sdk.CurrentTimeUs() - start
+
+return read_us * 1000 / iterations, ffi_us * 1000 / iterations, sum
+)";
+
+/**
+ * @return The sdk function reading a property the way its FFI field is declared, or nullptr if it has no scalar
+ *         numeric field.
+ */
+static const char* BenchmarkReader(const LayoutProperty& property)
+{
+    if (property.ArrayDim > 1)
+        return nullptr;
+
+    const int32_t size = property.ElementSize;
+    const auto& sized = [size](const char* reader, const int32_t expected)
+    {
+        return size == expected ? reader : nullptr;
+    };
+
+    switch (property.Kind)
+    {
+    case ClassKind::Int8Property:
+        return sized("ReadI8", 1);
+    case ClassKind::Int16Property:
+        return sized("ReadI16", 2);
+    case ClassKind::IntProperty:
+        return sized("ReadI32", 4);
+    case ClassKind::Int64Property:
+        return sized("ReadI64", 8);
+    case ClassKind::UInt16Property:
+        return sized("ReadU16", 2);
+    case ClassKind::UInt32Property:
+        return sized("ReadU32", 4);
+    case ClassKind::UInt64Property:
+        return sized("ReadU64", 8);
+    case ClassKind::FloatProperty:
+        return sized("ReadFloat32", 4);
+    case ClassKind::DoubleProperty:
+        return sized("ReadFloat64", 8);
+    case ClassKind::ByteProperty:
+    case ClassKind::EnumProperty:
+    case ClassKind::NumericProperty:
+    {
+        // Declared by size, see CdefGenerator::FieldType.
+        const bool is_signed = property.Kind == ClassKind::NumericProperty;
+        switch (size)
+        {
+        case 1:
+            return is_signed ? "ReadI8" : "ReadU8";
+        case 2:
+            return is_signed ? "ReadI16" : "ReadU16";
+        case 4:
+            return is_signed ? "ReadI32" : "ReadU32";
+        case 8:
+            return is_signed ? "ReadI64" : "ReadU64";
+        default:
+            return nullptr;
+        }
+    }
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Read a table mapping type names to { struct = address, size = bytes }, or to anything else for types that
+ *        were not declared for a struct.
+ */
+static DefinedTypes ReadDefinedTypes(lua_State* L, const int index)
+{
+    DefinedTypes types;
+
+    lua_pushnil(L);
+    while (lua_next(L, index) != 0)
+    {
+        if (lua_type(L, -2) == LUA_TSTRING)
+        {
+            DefinedType& type = types[lua_tostring(L, -2)];
+            if (lua_istable(L, -1))
+            {
+                lua_getfield(L, -1, "struct");
+                lua_getfield(L, -2, "size");
+                type.Struct = reinterpret_cast<const UStruct*>(lua_tointeger(L, -2));
+                type.Size = static_cast<int32_t>(lua_tointeger(L, -1));
+                lua_pop(L, 2);
+            }
+        }
+        lua_pop(L, 1);
+    }
+
+    return types;
+}
+
+static void WriteDefinedTypes(lua_State* L, const int index, const DefinedTypes& types)
+{
+    for (const auto& [name, type] : types)
+    {
+        lua_getfield(L, index, name.c_str());
+        const bool is_known = !lua_isnil(L, -1);
+        lua_pop(L, 1);
+        if (is_known)
+            continue;
+
+        if (type.Struct != nullptr)
+        {
+            lua_createtable(L, 0, 2);
+            lua_pushinteger(L, reinterpret_cast<lua_Integer>(type.Struct));
+            lua_setfield(L, -2, "struct");
+            lua_pushinteger(L, type.Size);
+            lua_setfield(L, -2, "size");
+        }
+        else
+        {
+            lua_pushboolean(L, true);
+        }
+        lua_setfield(L, index, name.c_str());
+    }
+}
+
+/**
+ * @brief Push the table of types this Lua state passed to ffi.cdef, creating it if needed.
+ * @return Its absolute stack index
+ */
+static int PushDefinedTypes(lua_State* L)
+{
+    lua_getfield(L, LUA_REGISTRYINDEX, FFI_TYPES_KEY);
+    if (!lua_istable(L, -1))
+    {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, LUA_REGISTRYINDEX, FFI_TYPES_KEY);
+    }
+    return lua_gettop(L);
+}
+
+/**
+ * @brief Pass the declarations of a struct or class to ffi.cdef unless this Lua state already has them.
+ * @return The name of its type
+ */
+static std::string DefineFFIType(lua_State* L, const UStruct* klass)
+{
+    const StackGuard guard(L);
+    const int types_index = PushDefinedTypes(L);
+
+    DefinedTypes defined = ReadDefinedTypes(L, types_index);
+    CdefGenerator generator(defined);
+    std::string type_name = generator.Add(klass);
+
+    if (const std::string& declarations = generator.Finish(); !declarations.empty())
+    {
+        lua_getglobal(L, "require");
+        lua_pushstring(L, "ffi");
+        lua_call(L, 1, 1);
+        lua_getfield(L, -1, "cdef");
+        lua_pushlstring(L, declarations.data(), declarations.size());
+        lua_call(L, 1, 0);
+
+        // Only remembered once ffi.cdef accepted them.
+        WriteDefinedTypes(L, types_index, defined);
+    }
+
+    return type_name;
+}
+
+int UnrealSDK::GenerateCdef(lua_State* L)
+{
+    const auto klass = reinterpret_cast<const UStruct*>(luaL_checkinteger(L, 1));
+    TCheckPtrHot(klass);
+
+    const bool has_types = lua_istable(L, 2);
+    DefinedTypes defined = has_types ? ReadDefinedTypes(L, 2) : DefinedTypes{};
+
+    CdefGenerator generator(defined);
+    const std::string& type_name = generator.Add(klass);
+
+    if (has_types)
+        WriteDefinedTypes(L, 2, defined);
+
+    const std::string& declarations = generator.Finish();
+    lua_pushlstring(L, declarations.data(), declarations.size());
+    lua_pushlstring(L, type_name.data(), type_name.size());
+    return 2;
+}
+
+int UnrealSDK::DefineFFI(lua_State* L)
+{
+    const auto klass = reinterpret_cast<const UStruct*>(luaL_checkinteger(L, -1));
+    TCheckPtrHot(klass);
+
+    const std::string& type_name = DefineFFIType(L, klass);
+    lua_pushlstring(L, type_name.data(), type_name.size());
+    return 1;
+}
+
+/**
+ * @brief Builds unreal.ffi from the engine type declarations and the addresses of the engine and flat functions.
+ */
+constexpr std::string_view ENGINE_FFI = R"lua(
+local ffi = require("ffi")
+local declarations, engine, flat = ...
+
+if declarations ~= "" then
+    ffi.cdef(declarations)
+end
+
+-- Objects are uintptr_t rather than void* so the numbers the rest of the SDK hands out can be passed as they are.
+local ENGINE_SIGNATURES = {
+    ProcessEvent = "void (*)(uintptr_t, uintptr_t, void*)",
+    FreeMemory = "void (*)(void*)",
+    GetObjectName = "void (*)(FString*, uintptr_t)",
+    StaticFindObject = "uintptr_t (*)(uintptr_t, uintptr_t, const uint16_t*, bool)",
+    GetAllActorsOfClass = "void (*)(uintptr_t, uintptr_t, TArray*)",
+    FNameToString = "FString* (*)(const FName*, FString*)",
+    WorldToScreen = "bool (*)(uintptr_t, Vector3, Vector2*, bool)",
+    DrawText = "void (*)(uintptr_t, uintptr_t, const FString*, Vector2, Vector2, FLinearColor, float, FLinearColor, "
+        .. "Vector2, bool, bool, bool, FLinearColor)",
+    DrawLine = "void (*)(uintptr_t, Vector2, Vector2, float, FLinearColor)",
+    DrawFilledRect = "void (*)(uintptr_t, FLinearColor, float, float, float, float)",
+    SizeOfText = "Vector2* (*)(uintptr_t, uint64_t*, uintptr_t, const FString*, Vector2)",
+}
+
+local FLAT_SIGNATURES = {
+    WorldToScreen = "bool (*)(float, float, float, float*)",
+    DrawText = "void (*)(uintptr_t, uintptr_t, const char*, float, float, int, int, int, int, bool)",
+    DrawLine = "void (*)(uintptr_t, float, float, float, float, float, int, int, int, int)",
+    DrawFilledRect = "void (*)(uintptr_t, uintptr_t, float, float, float, float, int, int, int, int)",
+    SizeOfText = "void (*)(uintptr_t, uintptr_t, const char*, float*)",
+}
+
+local module = { raw = {} }
+for name, address in pairs(engine) do
+    module.raw[name] = ffi.cast(ENGINE_SIGNATURES[name], address)
+end
+for name, address in pairs(flat) do
+    module[name] = ffi.cast(FLAT_SIGNATURES[name], address)
+end
+return module
+)lua";
+
+/*
+ * Engine functions with their struct arguments flattened, called by unreal.ffi. The JIT can't compile a call that
+ * passes a struct by value, so calling the engine pointers from Lua would leave the trace. Arguments are the same as
+ * the unreal functions with the same names.
+ */
+
+static bool FlatWorldToScreen(const float x, const float y, const float z, float* out)
+{
+    APlayerController* controller = UE::GetPlayerController();
+    if (controller == nullptr || out == nullptr)
+        return false;
+
+    Vector2 screen{};
+    if (!g_EP.WorldToScreen(controller, Vector3{x, y, z}, &screen, false))
+        return false;
+
+    out[0] = screen.X;
+    out[1] = screen.Y;
+    return true;
+}
+
+static void FlatDrawText(UObject* canvas, void* font, const char* text, const float x, const float y, const int r,
+                         const int g, const int b, const int a, const bool outlined)
+{
+#ifdef SCRIPT_SAFETY_ON
+    if (canvas == nullptr || text == nullptr)
+        return;
+#endif
+    UE::DrawText(canvas, font, g_TextCache.Get(text), Vector2{x, y}, FLinearColor::FromRGBA(r, g, b, a), outlined);
+}
+
+static void FlatDrawLine(UObject* canvas, const float x, const float y, const float x2, const float y2,
+                         const float thickness, const int r, const int g, const int b, const int a)
+{
+    g_EP.DrawLine(canvas, Vector2{x, y}, Vector2{x2, y2}, thickness, FLinearColor::FromRGBA(r, g, b, a));
+}
+
+static void FlatDrawFilledRect(UObject* canvas, UObject* hud, const float x, const float y, const float w,
+                               const float h, const int r, const int g, const int b, const int a)
+{
+#ifdef SCRIPT_SAFETY_ON
+    if (canvas == nullptr || hud == nullptr)
+        return;
+#endif
+    UE::DrawFilledRect(canvas, hud, x, y, w, h, FLinearColor::FromRGBA(r, g, b, a));
+}
+
+static void FlatSizeOfText(UObject* canvas, void* font, const char* text, float* out)
+{
+#ifdef SCRIPT_SAFETY_ON
+    if (canvas == nullptr || text == nullptr || out == nullptr)
+        return;
+#endif
+    const Vector2& size = g_TextCache.Measure(canvas, font, text);
+    out[0] = size.X;
+    out[1] = size.Y;
+}
+
+/**
+ * @brief Set field of the table on top of the stack to an address, unless it is null.
+ */
+template <typename T>
+static void SetAddress(lua_State* L, const char* field, T* address)
+{
+    if (address == nullptr)
+        return;
+
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(address));
+    lua_setfield(L, -2, field);
+}
+
+void UnrealSDK::InitEngineFFI(lua_State* L)
+{
+    const StackGuard guard(L);
+    const int types_index = PushDefinedTypes(L);
+
+    DefinedTypes defined = ReadDefinedTypes(L, types_index);
+    CdefGenerator generator(defined);
+    generator.AddEngineTypes();
+    const std::string& declarations = generator.Finish();
+
+    if (luaL_loadbuffer(L, ENGINE_FFI.data(), ENGINE_FFI.size(), "uescript:engine_ffi") != LUA_OK)
+    {
+        std::cout << "Failed to load unreal.ffi: " << lua_tostring(L, -1) << std::endl;
+        return;
+    }
+
+    lua_pushlstring(L, declarations.data(), declarations.size());
+
+    lua_newtable(L);
+    {
+        SetAddress(L, "ProcessEvent", g_EP.ProcessEvent);
+        SetAddress(L, "FreeMemory", g_EP.FreeMemory);
+        SetAddress(L, "GetObjectName", g_EP.GetObjectName);
+        SetAddress(L, "StaticFindObject", g_EP.StaticFindObject);
+        SetAddress(L, "GetAllActorsOfClass", g_EP.GetAllActorsOfClass);
+        SetAddress(L, "FNameToString", g_EP.FNameToString);
+        SetAddress(L, "WorldToScreen", g_EP.WorldToScreen);
+        SetAddress(L, "DrawText", g_EP.DrawText);
+        SetAddress(L, "DrawLine", g_EP.DrawLine);
+        SetAddress(L, "DrawFilledRect", g_EP.DrawFilledRect);
+        SetAddress(L, "SizeOfText", g_EP.SizeOfText);
+    }
+
+    // Flat functions are only useful when the engine function behind them was found.
+    lua_newtable(L);
+    {
+        SetAddress(L, "WorldToScreen", g_EP.WorldToScreen != nullptr ? FlatWorldToScreen : nullptr);
+        SetAddress(L, "DrawText", g_EP.DrawText != nullptr ? FlatDrawText : nullptr);
+        SetAddress(L, "DrawLine", g_EP.DrawLine != nullptr ? FlatDrawLine : nullptr);
+        SetAddress(L, "DrawFilledRect", g_EP.DrawFilledRect != nullptr ? FlatDrawFilledRect : nullptr);
+        SetAddress(L, "SizeOfText", g_EP.SizeOfText != nullptr ? FlatSizeOfText : nullptr);
+    }
+
+    if (lua_pcall(L, 3, 1, 0) != LUA_OK)
+    {
+        std::cout << "Failed to initialize unreal.ffi: " << lua_tostring(L, -1) << std::endl;
+        return;
+    }
+
+    // Only remembered once ffi.cdef accepted them.
+    WriteDefinedTypes(L, types_index, defined);
+
+    lua_getglobal(L, "unreal");
+    lua_insert(L, -2);
+    lua_setfield(L, -2, "ffi");
+}
+
+/**
+ * @brief Builds unreal.draw, which appends commands to the draw list buffer through the FFI.
+ */
+constexpr std::string_view DRAW_LIST = R"lua(
+local ffi = require("ffi")
+local bit = require("bit")
+local buffer_address, grow_address, grow_text_address, intern, get_stats = ...
+
+-- Same layout as DrawCommand and DrawListBuffer in draw_list.h.
+ffi.cdef[[
+typedef struct DrawCommand {
+    uint8_t Type;
+    bool Outlined;
+    uint16_t Reserved;
+    uint32_t Color;
+    float X;
+    float Y;
+    float X2;
+    float Y2;
+    float Thickness;
+    uint32_t Text;
+    uint64_t Object;
+} DrawCommand;
+typedef struct DrawListBuffer {
+    DrawCommand* Commands;
+    uint32_t Count;
+    uint32_t Capacity;
+    uint32_t Dropped;
+    uint32_t TextSize;
+    char* Text;
+    uint32_t TextCapacity;
+} DrawListBuffer;
+]]
+
+local buffer = ffi.cast("DrawListBuffer*", buffer_address)
+local grow = ffi.cast("bool (*)(void)", grow_address)
+local grow_text = ffi.cast("bool (*)(uint32_t)", grow_text_address)
+local band, bor, lshift = bit.band, bit.bor, bit.lshift
+
+local LINE, RECT, FILLED_RECT, TEXT = 0, 1, 2, 3
+local NO_TEXT = 0xFFFFFFFF
+local TRANSIENT_TEXT = 0x80000000
+
+local function rgba(r, g, b, a)
+    return bor(band(r, 0xFF), lshift(band(g, 0xFF), 8), lshift(band(b, 0xFF), 16), lshift(band(a, 0xFF), 24))
+end
+
+local function append(kind, r, g, b, a)
+    local count = buffer.Count
+    if count >= buffer.Capacity and not grow() then
+        buffer.Dropped = buffer.Dropped + 1
+        return nil
+    end
+    buffer.Count = count + 1
+
+    local command = buffer.Commands[count]
+    command.Type = kind
+    command.Color = rgba(r, g, b, a)
+    return command
+end
+
+-- Copies text into the frame's text, which is cleared on flush, so strings that change every frame are not kept.
+local function frame_text(text)
+    local used = buffer.TextSize
+    local size = used + #text + 1
+    if size > buffer.TextCapacity and not grow_text(size) then
+        return NO_TEXT
+    end
+
+    -- Copies the terminator too.
+    ffi.copy(buffer.Text + used, text)
+    buffer.TextSize = size
+    return TRANSIENT_TEXT + used
+end
+
+local draw = {}
+
+function draw.Line(x, y, x2, y2, thickness, r, g, b, a)
+    local command = append(LINE, r, g, b, a)
+    if command == nil then
+        return
+    end
+    command.X, command.Y, command.X2, command.Y2 = x, y, x2, y2
+    command.Thickness = thickness
+end
+
+function draw.Rect(x, y, w, h, r, g, b, a, thickness)
+    local command = append(RECT, r, g, b, a)
+    if command == nil then
+        return
+    end
+    command.X, command.Y, command.X2, command.Y2 = x, y, w, h
+    command.Thickness = thickness or 1
+end
+
+function draw.FilledRect(hud, x, y, w, h, r, g, b, a)
+    local command = append(FILLED_RECT, r, g, b, a)
+    if command == nil then
+        return
+    end
+    command.X, command.Y, command.X2, command.Y2 = x, y, w, h
+    command.Object = hud
+end
+
+-- text is a string or an id from draw.Intern.
+function draw.Text(font, text, x, y, r, g, b, a, outlined)
+    if type(text) == "string" then
+        text = frame_text(text)
+    end
+    if text == NO_TEXT then
+        buffer.Dropped = buffer.Dropped + 1
+        return
+    end
+
+    local command = append(TEXT, r, g, b, a)
+    if command == nil then
+        return
+    end
+    command.X, command.Y = x, y
+    command.Text = text
+    command.Object = font or 0
+    command.Outlined = outlined == true
+end
+
+draw.Intern = intern
+draw.GetStats = get_stats
+
+return draw
+)lua";
+
+static bool GrowDrawList()
+{
+    return g_DrawList.Grow();
+}
+
+static bool GrowDrawText(const uint32_t size)
+{
+    return g_DrawList.GrowText(size);
+}
+
+void UnrealSDK::InitDrawList(lua_State* L)
+{
+    const StackGuard guard(L);
+
+    // Ids, commands and measurements from a previous Lua state mean nothing to this one.
+    g_DrawList.Reset();
+    g_TextCache.Clear();
+
+    if (luaL_loadbuffer(L, DRAW_LIST.data(), DRAW_LIST.size(), "uescript:draw_list") != LUA_OK)
+    {
+        std::cout << "Failed to load unreal.draw: " << lua_tostring(L, -1) << std::endl;
+        return;
+    }
+
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(g_DrawList.Buffer()));
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(GrowDrawList));
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(GrowDrawText));
+    lua_pushcfunction(L, UnrealSDK::InternDrawText);
+    lua_pushcfunction(L, UnrealSDK::GetDrawStats);
+
+    if (lua_pcall(L, 5, 1, 0) != LUA_OK)
+    {
+        std::cout << "Failed to initialize unreal.draw: " << lua_tostring(L, -1) << std::endl;
+        return;
+    }
+
+    lua_getglobal(L, "unreal");
+    lua_insert(L, -2);
+    lua_setfield(L, -2, "draw");
+}
+
+int UnrealSDK::InternDrawText(lua_State* L)
+{
+    size_t length = 0;
+    const char* text = luaL_checklstring(L, 1, &length);
+
+    lua_pushinteger(L, g_DrawList.Intern({text, length}));
+    return 1;
+}
+
+int UnrealSDK::GetDrawStats(lua_State* L)
+{
+    const DrawListStats& stats = g_DrawList.Stats();
+
+    uint32_t total = 0;
+    for (const uint32_t count : stats.Commands)
+        total += count;
+
+    lua_createtable(L, 0, 7);
+
+    lua_pushinteger(L, total);
+    lua_setfield(L, -2, "commands");
+
+    lua_pushinteger(L, stats.Commands[static_cast<size_t>(DrawCommandType::Line)]);
+    lua_setfield(L, -2, "lines");
+
+    lua_pushinteger(L, stats.Commands[static_cast<size_t>(DrawCommandType::Rect)]);
+    lua_setfield(L, -2, "rects");
+
+    lua_pushinteger(L, stats.Commands[static_cast<size_t>(DrawCommandType::FilledRect)]);
+    lua_setfield(L, -2, "filled_rects");
+
+    lua_pushinteger(L, stats.Commands[static_cast<size_t>(DrawCommandType::Text)]);
+    lua_setfield(L, -2, "texts");
+
+    lua_pushinteger(L, stats.Dropped);
+    lua_setfield(L, -2, "dropped");
+
+    lua_pushinteger(L, stats.Flush.count());
+    lua_setfield(L, -2, "flush_us");
+
+    return 1;
+}
+
+int UnrealSDK::BenchmarkFFI(lua_State* L)
+{
+    const auto object = reinterpret_cast<const UObject*>(luaL_checkinteger(L, 1));
+    TCheckPtrHot(object);
+
+    const auto klass = reinterpret_cast<const UStruct*>(luaL_checkinteger(L, 2));
+    TCheckPtrHot(klass);
+
+    size_t length = 0;
+    const char* field = luaL_checklstring(L, 3, &length);
+    const lua_Integer iterations = luaL_optinteger(L, 4, 1000000);
+    if (iterations <= 0)
+        return luaL_argerror(L, 4, "expected a positive number of iterations");
+
+    const LayoutProperty* property = g_StructLayouts.Find(klass, {field, length});
+    if (property == nullptr)
+        return luaL_error(L, "no property %s", field);
+
+    const char* reader = BenchmarkReader(*property);
+    if (reader == nullptr)
+        return luaL_argerror(L, 3, "expected a numeric property that is not an array");
+
+    const std::string& type_name = DefineFFIType(L, klass);
+
+    if (luaL_loadbuffer(L, FFI_BENCHMARK.data(), FFI_BENCHMARK.size(), "uescript:ffi_benchmark") != LUA_OK)
+        return lua_error(L);
+
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(object));
+    lua_pushlstring(L, type_name.data(), type_name.size());
+    lua_pushvalue(L, 3);
+    lua_pushinteger(L, property->Offset);
+    lua_pushinteger(L, iterations);
+    lua_pushstring(L, reader);
+    lua_call(L, 6, 2);
+
+    std::cout << std::format("{}.{}: sdk.{} {:.1f} ns, ffi {:.1f} ns per read", type_name, field, reader,
+                             lua_tonumber(L, -2), lua_tonumber(L, -1)) << std::endl;
+    return 2;
+}
@@ -15,9 +15,55 @@ protected:
 
 private:
     /**
-     * @brief Expose Unreal Engine types to Lua.
+     * @brief Set unreal.ffi, the engine functions as LuaJIT FFI function pointers. unreal.ffi.raw has the bootstrapped
+     *        pointers with their declared signatures. unreal.ffi.WorldToScreen, DrawText, DrawLine, DrawFilledRect and
+     *        SizeOfText take scalars in place of the engine structs so calls from traces stay compiled, and take the
+     *        same arguments as the unreal functions. WorldToScreen and SizeOfText write to a float[2] instead of
+     *        returning numbers.
      */
-    static void GenerateUnrealTypes(lua_State* L);
+    static void InitEngineFFI(lua_State* L);
+    /**
+     * @brief Set unreal.draw, which queues Line, Rect, FilledRect and Text commands in the draw list. They are drawn
+     *        on the DrawTransition canvas after _CallbackDrawTransition returns, in the order they were queued.
+     */
+    static void InitDrawList(lua_State* L);
+    /**
+     * @brief unreal.draw.Intern(text). Pushes the id of a string for unreal.draw.Text, for text drawn every frame.
+     *        Ids last as long as the Lua state, so at most DrawList::MAX_STRINGS are handed out, NO_TEXT after that.
+     *        Strings passed to unreal.draw.Text directly are copied for one frame instead.
+     */
+    static int InternDrawText(lua_State* L);
+    /**
+     * @brief unreal.draw.GetStats(). Pushes what the last flush drew: commands, lines, rects, filled_rects, texts and
+     *        dropped counts, and flush_us.
+     */
+    static int GetDrawStats(lua_State* L);
+    /**
+     * @brief Expose Unreal Engine types to Lua from the snapshot saved by a previous session if it was written for this
+     *        build of the game, otherwise by crawling the UObjectArray.
+     */
+    static void LoadUnrealTypes(lua_State* L);
+    /**
+     * @brief Expose Unreal Engine types to Lua. Only slots of the UObjectArray that changed since the previous call are
+     *        crawled again, unreal.RegenerateTypes(true) sets full to rebuild from scratch. unreal.Types starts out
+     *        empty and builds a class table the first time it is indexed. Replaces any snapshot in use and saves a
+     *        new one if anything changed.
+     */
+    static void GenerateUnrealTypes(lua_State* L, bool full = false);
+    /**
+     * @brief Push an empty unreal.Types table that builds class tables on first access.
+     */
+    static void PushTypesProxy(lua_State* L);
+    /**
+     * @brief __index of unreal.Types. Builds and caches the table for an outer from the snapshot or the reflection
+     *        index.
+     */
+    static int IndexTypes(lua_State* L);
+    /**
+     * @brief unreal.GetTypeNames(). Pushes an array of every outer with members, since pairs(unreal.Types) only sees
+     *        the ones looked up so far.
+     */
+    static int GetTypeNames(lua_State* L);
 
     static int WorldToScreen(lua_State* L);
     static int DrawText(lua_State* L);
@@ -27,7 +73,22 @@ private:
     static int SizeOfText(lua_State* L);
 
     static int StaticFindObject(lua_State* L);
+    /**
+     * @brief unreal.FindObject(name). Pushes an object with exactly that name, or nil. Served from the object index.
+     */
+    static int FindObject(lua_State* L);
+    /**
+     * @brief unreal.FindObjects(query, [match], [limit]). Pushes an array of objects in UObjectArray order whose name
+     *        matches the query, where match is "exact" (default), "prefix" or "substring".
+     */
+    static int FindObjects(lua_State* L);
+    /**
+     * @brief Kept for existing scripts, same as the first result of unreal.FindObjects(search, "substring").
+     */
     static int FindObjectSlow(lua_State* L);
+    /**
+     * @brief Kept for existing scripts, same as unreal.FindObjects(search, "substring").
+     */
     static int FindAllObjectsSlow(lua_State* L);
     static int GetAllActorsOfClass(lua_State* L);
 
@@ -35,4 +96,34 @@ private:
 
     static int ProcessEvent(lua_State* L);
     static int GetObjectName(lua_State* L);
+    /**
+     * @brief unreal.IsA(object, class). Whether the class of an object is class or one of its subclasses.
+     */
+    static int IsA(lua_State* L);
+    /**
+     * @brief unreal.OffsetOf(class, name). Pushes the offset of a property declared by a struct or class or any of its
+     *        bases, or nil if there is none.
+     */
+    static int OffsetOf(lua_State* L);
+    /**
+     * @brief unreal.GetProperties(class). Pushes an array of every property of a struct or class, bases first, as
+     *        tables with name, offset, size, array_dim, kind, property and owner.
+     */
+    static int GetProperties(lua_State* L);
+    /**
+     * @brief unreal.GenerateCdef(class, [defined]). Pushes ffi.cdef declarations for a struct or class and the name of
+     *        its type. Names that are keys of defined are not declared again, a struct whose name is taken by a different
+     *        one is declared under a numbered name. Types declared are added to it as { struct, size } tables.
+     */
+    static int GenerateCdef(lua_State* L);
+    /**
+     * @brief unreal.DefineFFI(class). Declares a struct or class with ffi.cdef, once per Lua state, and pushes the name
+     *        of its type for ffi.cast.
+     */
+    static int DefineFFI(lua_State* L);
+    /**
+     * @brief unreal.BenchmarkFFI(object, class, field, [iterations]). Times reading a numeric field through the
+     *        sdk.Read function of its type and through the generated FFI type, pushes both in nanoseconds per read.
+     */
+    static int BenchmarkFFI(lua_State* L);
 };
@@ -4,8 +4,11 @@
 
 #include <lua/lua_engine.h>
 #include <utils/allocations.h>
+#include <utils/signature.h>
+#include <utils/signature_cache.h>
 
 constexpr int LUA_RESET_KEY = VK_F8;
+constexpr const char* SIGNATURE_CACHE_FILE = "signatures.cache";
 
 UEScript::UEScript(const HMODULE module)
     : m_Module(module)
@@ -16,6 +19,7 @@ UEScript::UEScript(const HMODULE module)
     InitConsole();
 
     g_AllocationTracker = std::make_unique<AllocationTracker>();
+    g_SignatureCache = std::make_unique<SignatureCache>(LuaEngine::GetHomeDirectory() / SIGNATURE_CACHE_FILE);
     m_LuaEngine = std::make_unique<LuaEngine>();
 
     InitHooks();
@@ -84,7 +88,11 @@ void UEScript::Shutdown()
     // Stupid.
     std::this_thread::sleep_for(chrono::milliseconds(200));
 
+    // Index builds run module code, they have to exit before it is unloaded.
+    Signature::Shutdown();
+
     g_AllocationTracker.reset(nullptr);
+    g_SignatureCache.reset(nullptr);
 
     m_LuaEngine.reset(nullptr);
     FreeConsole();
@@ -0,0 +1,58 @@
+#include "function_index.h"
+#include "pe_image.h"
+
+#include <algorithm>
+#include <iterator>
+
+FunctionIndex::FunctionIndex(const PEImage& image)
+{
+    const std::span<const pe::RuntimeFunction> functions = image.RuntimeFunctions();
+
+    m_Chunks.reserve(functions.size());
+    for (const pe::RuntimeFunction& function : functions)
+    {
+        if (function.EndAddress <= function.BeginAddress)
+            continue;
+
+        const pe::RuntimeFunction* primary = image.PrimaryRuntimeFunction(&function);
+        m_Chunks.push_back({function.BeginAddress, function.EndAddress, primary->BeginAddress});
+    }
+
+    // The directory is required to be sorted, but a bad image should not break the binary search.
+    if (!std::ranges::is_sorted(m_Chunks, {}, &Chunk::Begin))
+        std::ranges::sort(m_Chunks, {}, &Chunk::Begin);
+
+    m_ByFunction = m_Chunks;
+    std::ranges::sort(m_ByFunction, [](const Chunk& a, const Chunk& b)
+    {
+        if (a.Function != b.Function)
+            return a.Function < b.Function;
+
+        // The chunk at the start of the function goes first.
+        const bool a_primary = a.Begin == a.Function;
+        const bool b_primary = b.Begin == b.Function;
+        if (a_primary != b_primary)
+            return a_primary;
+
+        return a.Begin < b.Begin;
+    });
+}
+
+const FunctionIndex::Chunk* FunctionIndex::FindChunk(const uint32_t rva) const
+{
+    const auto it = std::ranges::upper_bound(m_Chunks, rva, {}, &Chunk::Begin);
+    if (it == m_Chunks.begin())
+        return nullptr;
+
+    const Chunk& chunk = *std::prev(it);
+    return rva < chunk.End ? &chunk : nullptr;
+}
+
+std::span<const FunctionIndex::Chunk> FunctionIndex::FunctionChunks(const uint32_t function) const
+{
+    const auto [first, last] = std::ranges::equal_range(m_ByFunction, function, {}, &Chunk::Function);
+    if (first == last || first->Begin != function)
+        return {};
+
+    return {first, last};
+}
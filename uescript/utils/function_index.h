@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class PEImage;
+
+/**
+ * @brief Function boundaries of a module, from its exception directory (.pdata). Answers "which function contains
+ *        this address" with a binary search.
+ *
+ * Functions can be split into several chunks (e.g. cold paths moved to the end of .text). Every chunk knows the
+ * function it belongs to. Leaf functions that never touch the stack have no entry and are unknown to the index.
+ */
+class FunctionIndex final
+{
+public:
+    struct Chunk
+    {
+        /** [Begin, End) RVA range of the chunk **/
+        uint32_t Begin;
+        uint32_t End;
+        /** RVA of the start of the function this chunk belongs to **/
+        uint32_t Function;
+    };
+
+    explicit FunctionIndex(const PEImage& image);
+
+    /**
+     * @return The chunk containing an RVA, or nullptr.
+     */
+    const Chunk* FindChunk(uint32_t rva) const;
+
+    /**
+     * @param function RVA of the start of a function
+     * @return Every chunk of the function. The first is the one starting at the function, the rest are in address
+     *         order. Empty if it is not the start of a known function.
+     */
+    std::span<const Chunk> FunctionChunks(uint32_t function) const;
+
+    size_t Size() const
+    {
+        return m_Chunks.size();
+    }
+
+private:
+    /** Sorted by Begin **/
+    std::vector<Chunk> m_Chunks{};
+    /** The same chunks grouped by function, see FunctionChunks **/
+    std::vector<Chunk> m_ByFunction{};
+};
@@ -0,0 +1,136 @@
+#include "gram_index.h"
+#include "pattern.h"
+#include "pe_image.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+/** Grams indexed between checks for a stop request **/
+static constexpr size_t STOP_CHECK_INTERVAL = 1 << 20;
+
+static uint32_t LoadGram(const uint8_t* data)
+{
+    uint32_t gram;
+    std::memcpy(&gram, data, sizeof(gram));
+    return gram;
+}
+
+GramIndex::GramIndex(const PEImage& image, const std::stop_token stop)
+    : GramIndex(image.CodeRange().first, image.CodeRange().second, stop)
+{
+}
+
+GramIndex::GramIndex(const uint8_t* begin, const uint8_t* end, const std::stop_token stop) : m_Begin(begin), m_End(end)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const size_t size = begin != nullptr && end > begin ? static_cast<size_t>(end - begin) : 0;
+    const size_t grams = size >= GRAM ? size - GRAM + 1 : 0;
+
+    // Roughly four offsets per bucket keeps buckets short without the table outweighing the offsets.
+    const uint32_t bits = std::clamp<uint32_t>(static_cast<uint32_t>(std::bit_width(grams)), 18, 26) - 2;
+    m_Shift = 32 - bits;
+
+    // Counting sort: size the buckets, then place offsets in ascending order.
+    m_Buckets.assign((size_t{1} << bits) + 1, 0);
+    for (size_t offset = 0; offset < grams; offset++)
+    {
+        if (offset % STOP_CHECK_INTERVAL == 0 && stop.stop_requested())
+        {
+            m_Buckets.assign(m_Buckets.size(), 0);
+            return;
+        }
+
+        if (const uint32_t gram = LoadGram(begin + offset); !IsPadding(gram))
+            m_Buckets[BucketOf(gram) + 1]++;
+    }
+
+    for (size_t bucket = 1; bucket < m_Buckets.size(); bucket++)
+        m_Buckets[bucket] += m_Buckets[bucket - 1];
+
+    m_Offsets.resize(m_Buckets.back());
+    {
+        std::vector<uint32_t> cursors(m_Buckets.begin(), m_Buckets.end() - 1);
+        for (size_t offset = 0; offset < grams; offset++)
+        {
+            if (offset % STOP_CHECK_INTERVAL == 0 && stop.stop_requested())
+            {
+                m_Buckets.assign(m_Buckets.size(), 0);
+                m_Offsets.clear();
+                return;
+            }
+
+            if (const uint32_t gram = LoadGram(begin + offset); !IsPadding(gram))
+                m_Offsets[cursors[BucketOf(gram)]++] = static_cast<uint32_t>(offset);
+        }
+    }
+
+    m_BuildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+size_t GramIndex::BucketOf(const uint32_t gram) const
+{
+    // Fibonacci hashing, the top bits of the product are well mixed.
+    return (gram * 0x9E3779B1u) >> m_Shift;
+}
+
+std::optional<const uint8_t*> GramIndex::Find(const Pattern& pattern) const
+{
+    const uint8_t* bytes = pattern.Bytes().data();
+    const uint8_t* mask = pattern.Mask().data();
+    const size_t pattern_size = pattern.Size();
+
+    // Pick the gram with the fewest candidates, the bucket size is known without touching the offsets.
+    size_t best_offset = 0;
+    size_t best_count = std::numeric_limits<size_t>::max();
+    for (size_t offset = 0; offset + GRAM <= pattern_size; offset++)
+    {
+        if (LoadGram(mask + offset) != 0xFFFFFFFF)
+            continue;
+
+        const uint32_t gram = LoadGram(bytes + offset);
+        if (IsPadding(gram))
+            continue;
+
+        const size_t bucket = BucketOf(gram);
+        if (const size_t count = m_Buckets[bucket + 1] - m_Buckets[bucket]; count < best_count)
+        {
+            best_offset = offset;
+            best_count = count;
+        }
+    }
+
+    if (best_count == std::numeric_limits<size_t>::max())
+    {
+        ++m_Misses;
+        return {};
+    }
+
+    ++m_Hits;
+
+    const size_t size = static_cast<size_t>(m_End - m_Begin);
+    const uint32_t gram = LoadGram(bytes + best_offset);
+    const size_t bucket = BucketOf(gram);
+
+    // Offsets are ascending, so the first verified candidate is the same match a linear scan returns.
+    uint64_t verified = 0;
+    const uint8_t* match = nullptr;
+    for (uint32_t i = m_Buckets[bucket]; i < m_Buckets[bucket + 1]; i++)
+    {
+        const size_t offset = m_Offsets[i];
+        if (offset < best_offset || offset - best_offset + pattern_size > size)
+            continue;
+
+        verified++;
+        if (const uint8_t* start = m_Begin + (offset - best_offset); pattern.Matches(start))
+        {
+            match = start;
+            break;
+        }
+    }
+
+    m_Candidates += verified;
+    return match;
+}
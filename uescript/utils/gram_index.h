@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+class PEImage;
+class Pattern;
+
+/**
+ * @brief Maps every 4-byte sequence (gram) in a module's code to the offsets it occurs at, so a pattern can be found
+ *        by verifying a handful of candidates instead of scanning the whole range.
+ *
+ * Grams are hashed into buckets, each holding its offsets in ascending order. Padding grams (00000000 and CCCCCCCC)
+ * are not indexed. The index costs about four bytes per byte of code and reflects the code at the time it was built,
+ * candidates are always verified against the current memory.
+ */
+class GramIndex final
+{
+public:
+    static constexpr size_t GRAM = 4;
+
+    /**
+     * @brief Index the code range of an image. The build checks stop between chunks, an index whose build was stopped
+     *        is left empty and should be discarded.
+     */
+    explicit GramIndex(const PEImage& image, std::stop_token stop = {});
+    GramIndex(const uint8_t* begin, const uint8_t* end, std::stop_token stop = {});
+
+    /**
+     * @brief Find the first match of a pattern using the bucket of its rarest wildcard-free gram.
+     * @return The match or nullptr if there is none, or an empty optional if the pattern has no indexed gram and must
+     *         be scanned for instead
+     */
+    std::optional<const uint8_t*> Find(const Pattern& pattern) const;
+
+    const uint8_t* Begin() const
+    {
+        return m_Begin;
+    }
+
+    const uint8_t* End() const
+    {
+        return m_End;
+    }
+
+    /**
+     * @return Bytes allocated for the index.
+     */
+    size_t MemoryUsage() const
+    {
+        return (m_Buckets.capacity() + m_Offsets.capacity()) * sizeof(uint32_t);
+    }
+
+    std::chrono::microseconds BuildTime() const
+    {
+        return m_BuildTime;
+    }
+
+    /**
+     * @return Patterns found (or ruled out) through the index.
+     */
+    uint64_t Hits() const
+    {
+        return m_Hits;
+    }
+
+    /**
+     * @return Patterns the index could not answer because they have no wildcard-free gram.
+     */
+    uint64_t Misses() const
+    {
+        return m_Misses;
+    }
+
+    /**
+     * @return Candidate positions verified over all hits.
+     */
+    uint64_t Candidates() const
+    {
+        return m_Candidates;
+    }
+
+    /**
+     * @return Whether a gram is left out of the index.
+     */
+    static bool IsPadding(const uint32_t gram)
+    {
+        return gram == 0x00000000 || gram == 0xCCCCCCCC;
+    }
+
+private:
+    size_t BucketOf(uint32_t gram) const;
+
+    const uint8_t* m_Begin{nullptr};
+    const uint8_t* m_End{nullptr};
+    uint32_t m_Shift{32};
+    /** Start of each bucket in m_Offsets, with one extra entry holding the total **/
+    std::vector<uint32_t> m_Buckets{};
+    /** Offsets from m_Begin, grouped by bucket and ascending within each **/
+    std::vector<uint32_t> m_Offsets{};
+    std::chrono::microseconds m_BuildTime{0};
+
+    mutable std::atomic_uint64_t m_Hits{0};
+    mutable std::atomic_uint64_t m_Misses{0};
+    mutable std::atomic_uint64_t m_Candidates{0};
+};
@@ -0,0 +1,110 @@
+#include "image_scanner.h"
+
+#include <tuple>
+
+ImageScanner::ImageScanner(const PEImage& image, ModuleIdentity identity, SignatureCache* cache)
+    : m_Image(image), m_Identity(std::move(identity)), m_Cache(cache)
+{
+    std::tie(m_Begin, m_End) = image.CodeRange();
+}
+
+const uint8_t* ImageScanner::Find(const Pattern& pattern, const bool parallel) const
+{
+    const std::string& key = pattern.ToString();
+
+    const uint8_t* match = FindCached(key, pattern);
+    if (match != nullptr)
+        return match;
+
+    std::optional<const uint8_t*> indexed{};
+    if (m_Index != nullptr)
+        indexed = m_Index->Find(pattern);
+
+    if (indexed.has_value())
+        match = indexed.value();
+    else
+        match = parallel
+                    ? PatternScanner::FindParallel(m_Begin, m_End, pattern)
+                    : PatternScanner::Find(m_Begin, m_End, pattern);
+    InsertCached(key, match);
+    return match;
+}
+
+std::vector<const uint8_t*> ImageScanner::FindMany(const std::vector<Pattern>& patterns) const
+{
+    std::vector<const uint8_t*> matches(patterns.size(), nullptr);
+    std::vector<std::string> keys(patterns.size());
+
+    // Only patterns missing from the cache that the index can't answer are scanned for.
+    std::vector<Pattern> uncached;
+    std::vector<size_t> uncached_slots;
+
+    for (size_t i = 0; i < patterns.size(); i++)
+    {
+        keys[i] = patterns[i].ToString();
+        matches[i] = FindCached(keys[i], patterns[i]);
+
+        if (matches[i] != nullptr)
+            continue;
+
+        std::optional<const uint8_t*> indexed{};
+        if (m_Index != nullptr)
+            indexed = m_Index->Find(patterns[i]);
+
+        if (indexed.has_value())
+        {
+            matches[i] = indexed.value();
+            InsertCached(keys[i], matches[i]);
+        }
+        else
+        {
+            uncached.push_back(patterns[i]);
+            uncached_slots.push_back(i);
+        }
+    }
+
+    if (uncached.empty())
+        return matches;
+
+    const MultiPattern multi(std::move(uncached));
+    const std::vector<const uint8_t*>& found = PatternScanner::FindMany(m_Begin, m_End, multi);
+
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        const size_t slot = uncached_slots[i];
+        matches[slot] = found[i];
+        InsertCached(keys[slot], found[i]);
+    }
+
+    return matches;
+}
+
+const uint8_t* ImageScanner::FindCached(const std::string& key, const Pattern& pattern) const
+{
+    if (m_Cache == nullptr)
+        return nullptr;
+
+    const std::optional<uint32_t>& rva = m_Cache->Lookup(m_Identity, key);
+    if (!rva.has_value())
+        return nullptr;
+
+    // RVAs are layout independent, so entries recorded from a file on disk resolve in the loaded module too.
+    const uint8_t* cached = m_Image.RvaToPointer(rva.value());
+    if (cached != nullptr && cached >= m_Begin && cached < m_End && static_cast<size_t>(m_End - cached) >= pattern.
+        Size() && pattern.Matches(cached))
+    {
+        return cached;
+    }
+
+    m_Cache->Remove(m_Identity, key);
+    return nullptr;
+}
+
+void ImageScanner::InsertCached(const std::string& key, const uint8_t* match) const
+{
+    if (m_Cache == nullptr || match == nullptr)
+        return;
+
+    if (const std::optional<uint32_t>& rva = m_Image.PointerToRva(match); rva.has_value())
+        m_Cache->Insert(m_Identity, key, rva.value());
+}
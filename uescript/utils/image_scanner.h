@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gram_index.h"
+#include "pattern.h"
+#include "pe_image.h"
+#include "signature_cache.h"
+
+/**
+ * @brief Scans the code of a PE image, consulting a signature cache first and recording what it finds. This is the
+ *        part of the sig library that both the DLL and offline tools use, so results are interchangeable.
+ */
+class ImageScanner final
+{
+public:
+    /**
+     * @param cache Cache to consult and update, nullptr to always scan
+     */
+    ImageScanner(const PEImage& image, ModuleIdentity identity, SignatureCache* cache);
+
+    /**
+     * @brief Find the first match of a pattern in the code range.
+     * @param parallel Split the scan across threads (see PatternScanner::FindParallel)
+     */
+    const uint8_t* Find(const Pattern& pattern, bool parallel = false) const;
+
+    /**
+     * @brief Find the first match of each pattern. Patterns missing from the cache are found in a single pass.
+     * @return Matches in the same order as the patterns, nullptr for patterns that did not match
+     */
+    std::vector<const uint8_t*> FindMany(const std::vector<Pattern>& patterns) const;
+
+    /**
+     * @brief Answer patterns from an index over the same code range before scanning for them.
+     * @param index Index to use, nullptr to always scan
+     */
+    void SetIndex(const GramIndex* index)
+    {
+        m_Index = index != nullptr && index->Begin() == m_Begin && index->End() == m_End ? index : nullptr;
+    }
+
+    const PEImage& Image() const
+    {
+        return m_Image;
+    }
+
+    const ModuleIdentity& Identity() const
+    {
+        return m_Identity;
+    }
+
+    /**
+     * @return The [begin, end) range that is scanned.
+     */
+    std::pair<const uint8_t*, const uint8_t*> Range() const
+    {
+        return {m_Begin, m_End};
+    }
+
+private:
+    /**
+     * @brief Look a pattern up in the cache. Cached results are verified against the pattern before use.
+     * @return The cached match or nullptr on a cache miss
+     */
+    const uint8_t* FindCached(const std::string& key, const Pattern& pattern) const;
+    void InsertCached(const std::string& key, const uint8_t* match) const;
+
+    const PEImage& m_Image;
+    ModuleIdentity m_Identity;
+    SignatureCache* m_Cache;
+    const uint8_t* m_Begin;
+    const uint8_t* m_End;
+    const GramIndex* m_Index{nullptr};
+};
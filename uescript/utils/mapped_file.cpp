@@ -0,0 +1,106 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::optional<MappedFile> MappedFile::Open(const std::filesystem::path& path)
+{
+    MappedFile file;
+
+#ifdef _WIN32
+    const HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return {};
+    file.m_File = handle;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+        return {};
+    file.m_Size = static_cast<size_t>(size.QuadPart);
+
+    file.m_Mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (file.m_Mapping == nullptr)
+        return {};
+
+    file.m_Data = static_cast<const uint8_t*>(MapViewOfFile(file.m_Mapping, FILE_MAP_READ, 0, 0, 0));
+    if (file.m_Data == nullptr)
+        return {};
+#else
+    file.m_File = open(path.c_str(), O_RDONLY);
+    if (file.m_File < 0)
+        return {};
+
+    struct stat info{};
+    if (fstat(file.m_File, &info) != 0 || info.st_size == 0)
+        return {};
+    file.m_Size = static_cast<size_t>(info.st_size);
+
+    void* data = mmap(nullptr, file.m_Size, PROT_READ, MAP_PRIVATE, file.m_File, 0);
+    if (data == MAP_FAILED)
+        return {};
+    file.m_Data = static_cast<const uint8_t*>(data);
+#endif
+
+    return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_Data = std::exchange(other.m_Data, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+#ifdef _WIN32
+        m_File = std::exchange(other.m_File, nullptr);
+        m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#else
+        m_File = std::exchange(other.m_File, -1);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (m_Data != nullptr)
+        UnmapViewOfFile(m_Data);
+    if (m_Mapping != nullptr)
+        CloseHandle(m_Mapping);
+    if (m_File != nullptr)
+        CloseHandle(m_File);
+
+    m_Mapping = nullptr;
+    m_File = nullptr;
+#else
+    if (m_Data != nullptr)
+        munmap(const_cast<uint8_t*>(m_Data), m_Size);
+    if (m_File >= 0)
+        close(m_File);
+
+    m_File = -1;
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
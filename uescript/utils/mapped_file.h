@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+/**
+ * @brief A read-only memory mapping of a whole file. Works on Windows and POSIX so offline tools can share it.
+ */
+class MappedFile final
+{
+public:
+    /**
+     * @return The mapped file or an empty optional if it could not be opened or mapped
+     */
+    static std::optional<MappedFile> Open(const std::filesystem::path& path);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    // No copy constructors.
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(const MappedFile&) = delete;
+
+    const uint8_t* Data() const
+    {
+        return m_Data;
+    }
+
+    size_t Size() const
+    {
+        return m_Size;
+    }
+
+private:
+    MappedFile() = default;
+
+    void Close();
+
+    const uint8_t* m_Data{nullptr};
+    size_t m_Size{0};
+#ifdef _WIN32
+    void* m_File{nullptr};
+    void* m_Mapping{nullptr};
+#else
+    int m_File{-1};
+#endif
+};
@@ -0,0 +1,193 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "pe_image.h"
+
+/**
+ * @brief Data derived from a module that is built once and reused, e.g. an index over its code. Entries are keyed by
+ *        the module's base address and rebuilt if a different build of a module is loaded there.
+ *        Data can also be built on a background thread and picked up once it is ready. The cache owns its build
+ *        threads, Shutdown must run before the code they execute can be unloaded.
+ * @tparam T Constructible from a const PEImage&, optionally followed by a std::stop_token checked during the build
+ */
+template <typename T>
+class ModuleCache final
+{
+public:
+    ModuleCache() = default;
+    ModuleCache(const ModuleCache&) = delete;
+    ModuleCache& operator=(const ModuleCache&) = delete;
+
+    ~ModuleCache()
+    {
+        Shutdown();
+    }
+
+    /**
+     * @brief Get the data for a module, building it first if needed. The result stays valid after the entry is
+     *        replaced.
+     */
+    std::shared_ptr<const T> Get(const PEImage& image)
+    {
+        std::unique_lock lock(m_Mutex);
+
+        Entry& entry = Lookup(image);
+        if (entry.Pending.valid())
+        {
+            // Wait for the background build rather than starting a second one.
+            const std::shared_future<std::shared_ptr<const T>> pending = entry.Pending;
+            lock.unlock();
+            pending.wait();
+            lock.lock();
+            Resolve(Lookup(image));
+        }
+
+        Entry& current = Lookup(image);
+        if (current.Value == nullptr)
+            current.Value = Build(image, {});
+
+        return current.Value;
+    }
+
+    /**
+     * @brief Start building the data for a module on a background thread, unless it is already built or building.
+     *        Does nothing after Shutdown.
+     */
+    void Prepare(const PEImage& image)
+    {
+        std::scoped_lock lock(m_Mutex);
+
+        if (m_IsShutDown)
+            return;
+
+        Entry& entry = Lookup(image);
+        if (entry.Value != nullptr || entry.Pending.valid())
+            return;
+
+        std::promise<std::shared_ptr<const T>> promise;
+        entry.Pending = promise.get_future().share();
+
+        m_Builders.emplace_back([promise = std::move(promise), image](const std::stop_token stop) mutable
+        {
+            try
+            {
+                std::shared_ptr<const T> value = Build(image, stop);
+
+                // A stopped build may be incomplete, drop it like a failed one.
+                promise.set_value(stop.stop_requested() ? nullptr : std::move(value));
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+        });
+    }
+
+    /**
+     * @brief Stop background builds and wait for them to exit. Must not be called while the loader lock is held
+     *        (e.g. from DllMain), since exiting threads need it.
+     */
+    void Shutdown()
+    {
+        std::vector<std::jthread> builders;
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_IsShutDown = true;
+            builders = std::move(m_Builders);
+        }
+
+        for (std::jthread& builder : builders)
+            builder.request_stop();
+
+        // Joined outside the lock, a build never takes it but Get may be waiting on one.
+        for (std::jthread& builder : builders)
+            builder.join();
+    }
+
+    /**
+     * @brief Get the data for a module without building it.
+     * @return The data if it is built, nullptr if it is still building, or an empty optional if it was never
+     *         requested (or failed to build)
+     */
+    std::optional<std::shared_ptr<const T>> Peek(const PEImage& image)
+    {
+        std::scoped_lock lock(m_Mutex);
+
+        Entry& entry = Lookup(image);
+        Resolve(entry);
+
+        if (entry.Value == nullptr && !entry.Pending.valid())
+            return {};
+
+        return entry.Value;
+    }
+
+private:
+    struct Entry
+    {
+        uint32_t TimeDateStamp{0};
+        uint32_t SizeOfImage{0};
+        std::shared_ptr<const T> Value{};
+        std::shared_future<std::shared_ptr<const T>> Pending{};
+    };
+
+    static std::shared_ptr<const T> Build(const PEImage& image, const std::stop_token& stop)
+    {
+        if constexpr (std::is_constructible_v<T, const PEImage&, std::stop_token>)
+            return std::make_shared<const T>(image, stop);
+        else
+            return std::make_shared<const T>(image);
+    }
+
+    /**
+     * @brief Get the entry for a module, resetting it if a different build of the module is loaded at its base.
+     */
+    Entry& Lookup(const PEImage& image)
+    {
+        const uint32_t timestamp = image.Headers().FileHeader.TimeDateStamp;
+        const uint32_t size = image.Headers().OptionalHeader.SizeOfImage;
+
+        Entry& entry = m_Entries[image.Base()];
+        if (entry.TimeDateStamp != timestamp || entry.SizeOfImage != size)
+            entry = {timestamp, size, nullptr, {}};
+
+        return entry;
+    }
+
+    /**
+     * @brief Move the result of a finished background build into the entry. A failed build is dropped so it can be
+     *        requested again.
+     */
+    static void Resolve(Entry& entry)
+    {
+        if (!entry.Pending.valid() || entry.Pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+
+        try
+        {
+            entry.Value = entry.Pending.get();
+        }
+        catch (...)
+        {
+            entry.Value = nullptr;
+        }
+        entry.Pending = {};
+    }
+
+    std::mutex m_Mutex{};
+    std::unordered_map<const uint8_t*, Entry> m_Entries{};
+    /** Background builds, finished ones are joined on Shutdown **/
+    std::vector<std::jthread> m_Builders{};
+    bool m_IsShutDown{false};
+};
@@ -0,0 +1,588 @@
+#include "pattern.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PATTERN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define PATTERN_SSE2
+#endif
+
+/**
+ * @brief Rough ranking of how often each byte appears in x64 code. Higher is more common. Bytes not listed are
+ *        considered rare.
+ */
+static constexpr std::array<uint8_t, 256> ByteFrequency = []
+{
+    std::array<uint8_t, 256> table{};
+    table.fill(1);
+
+    // Padding, small immediates and sign-extended negatives.
+    table[0x00] = 255;
+    table[0xFF] = 200;
+    table[0xCC] = 180;
+    table[0x90] = 120;
+    table[0x01] = 110;
+
+    // REX prefixes.
+    table[0x48] = 240;
+    table[0x4C] = 150;
+    table[0x49] = 130;
+    table[0x44] = 130;
+    table[0x41] = 120;
+    table[0x4D] = 80;
+    table[0x45] = 70;
+    table[0x40] = 60;
+
+    // mov, lea, add/sub/cmp group, test, call, jmp, jcc, ret.
+    table[0x8B] = 230;
+    table[0x89] = 200;
+    table[0x8D] = 160;
+    table[0x83] = 150;
+    table[0x0F] = 140;
+    table[0xE8] = 140;
+    table[0x85] = 110;
+    table[0xC3] = 90;
+    table[0xE9] = 80;
+    table[0x74] = 90;
+    table[0x75] = 80;
+    table[0xEB] = 60;
+    table[0x33] = 70;
+    table[0xC7] = 70;
+    table[0xC0] = 90;
+
+    // Common ModRM and SIB bytes.
+    table[0x24] = 150;
+    table[0x05] = 100;
+    table[0x0D] = 90;
+    table[0x15] = 80;
+    table[0x5C] = 90;
+    table[0x54] = 80;
+    table[0x7C] = 70;
+    table[0x10] = 90;
+    table[0x08] = 90;
+    table[0x20] = 90;
+    table[0x28] = 80;
+    table[0x30] = 80;
+    table[0x38] = 70;
+    table[0xF8] = 60;
+    table[0xD8] = 60;
+    table[0xC1] = 70;
+    table[0xC8] = 70;
+    table[0xCB] = 60;
+    table[0xD9] = 60;
+    table[0xE0] = 50;
+    return table;
+}();
+
+static bool ParseNibble(const char c, uint8_t& out)
+{
+    if (c >= '0' && c <= '9')
+        out = static_cast<uint8_t>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+        out = static_cast<uint8_t>(c - 'a' + 0xA);
+    else if (c >= 'A' && c <= 'F')
+        out = static_cast<uint8_t>(c - 'A' + 0xA);
+    else
+        return false;
+    return true;
+}
+
+std::optional<Pattern> Pattern::Compile(const std::string_view signature)
+{
+    Pattern pattern;
+
+    size_t i = 0;
+    while (i < signature.size())
+    {
+        if (signature[i] == ' ' || signature[i] == '\t')
+        {
+            i++;
+            continue;
+        }
+
+        // Token is either "?", "??" or two hex digits.
+        size_t token_end = i;
+        while (token_end < signature.size() && signature[token_end] != ' ' && signature[token_end] != '\t')
+            token_end++;
+
+        const std::string_view token = signature.substr(i, token_end - i);
+        i = token_end;
+
+        if (token == "?" || token == "??")
+        {
+            pattern.m_Bytes.push_back(0);
+            pattern.m_Mask.push_back(0x00);
+            continue;
+        }
+
+        uint8_t high, low;
+        if (token.size() != 2 || !ParseNibble(token[0], high) || !ParseNibble(token[1], low))
+            return {};
+
+        pattern.m_Bytes.push_back(static_cast<uint8_t>(high << 4 | low));
+        pattern.m_Mask.push_back(0xFF);
+    }
+
+    // Trailing wildcards can never change the result but would make matches near the end of a range fail.
+    while (!pattern.m_Mask.empty() && pattern.m_Mask.back() == 0x00)
+    {
+        pattern.m_Bytes.pop_back();
+        pattern.m_Mask.pop_back();
+    }
+
+    if (pattern.m_Bytes.empty())
+        return {};
+
+    pattern.SelectAnchors();
+    return pattern;
+}
+
+Pattern Pattern::FromBytes(const uint8_t* bytes, const size_t size)
+{
+    Pattern pattern;
+    pattern.m_Bytes.assign(bytes, bytes + size);
+    pattern.m_Mask.assign(size, 0xFF);
+    pattern.SelectAnchors();
+    return pattern;
+}
+
+std::string Pattern::ToString() const
+{
+    constexpr char digits[] = "0123456789ABCDEF";
+
+    std::string result;
+    result.reserve(m_Bytes.size() * 3);
+    for (size_t i = 0; i < m_Bytes.size(); i++)
+    {
+        if (i != 0)
+            result += ' ';
+
+        if (m_Mask[i] == 0x00)
+        {
+            result += '?';
+            continue;
+        }
+
+        result += digits[m_Bytes[i] >> 4];
+        result += digits[m_Bytes[i] & 0x0F];
+    }
+    return result;
+}
+
+void Pattern::SelectAnchors()
+{
+    constexpr int none = 256;
+
+    // Ties are broken by position so results stay stable for a given signature.
+    int best = none, second = none;
+    for (size_t i = 0; i < m_Bytes.size(); i++)
+    {
+        if (m_Mask[i] == 0x00)
+            continue;
+
+        const int frequency = ByteFrequency[m_Bytes[i]];
+        if (best == none || frequency < best)
+        {
+            // Prefer a second anchor that compares a different byte value.
+            if (best != none && m_Bytes[m_Anchor] != m_Bytes[i])
+            {
+                second = best;
+                m_SecondAnchor = m_Anchor;
+            }
+            best = frequency;
+            m_Anchor = i;
+        }
+        else if ((second == none || frequency < second) && m_Bytes[i] != m_Bytes[m_Anchor])
+        {
+            second = frequency;
+            m_SecondAnchor = i;
+        }
+    }
+
+    if (second == none)
+        m_SecondAnchor = m_Anchor;
+}
+
+bool Pattern::Matches(const uint8_t* data) const
+{
+    const uint8_t* bytes = m_Bytes.data();
+    const uint8_t* mask = m_Mask.data();
+    const size_t size = m_Bytes.size();
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if ((data[i] & mask[i]) != bytes[i])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Scalar fallback. memchr is vectorized by every C runtime we care about.
+ */
+static const uint8_t* FindScalar(const uint8_t* begin, const uint8_t* end, const Pattern& pattern)
+{
+    const size_t size = pattern.Size();
+    if (static_cast<size_t>(end - begin) < size)
+        return nullptr;
+
+    const size_t anchor = pattern.AnchorOffset();
+    const uint8_t anchor_byte = pattern.AnchorByte();
+
+    // Anchor positions past this can't start a full match.
+    const uint8_t* anchor_end = end - size + anchor + 1;
+
+    const uint8_t* cur = begin + anchor;
+    while (cur < anchor_end)
+    {
+        const auto hit = static_cast<const uint8_t*>(std::memchr(cur, anchor_byte, anchor_end - cur));
+        if (hit == nullptr)
+            return nullptr;
+
+        if (const uint8_t* start = hit - anchor; pattern.Matches(start))
+            return start;
+
+        cur = hit + 1;
+    }
+
+    return nullptr;
+}
+
+const uint8_t* PatternScanner::Find(const uint8_t* begin, const uint8_t* end, const Pattern& pattern)
+{
+    const size_t size = pattern.Size();
+    if (begin == nullptr || end <= begin || static_cast<size_t>(end - begin) < size)
+        return nullptr;
+
+#if defined(PATTERN_AVX2) || defined(PATTERN_SSE2)
+#ifdef PATTERN_AVX2
+    using Vec = __m256i;
+    constexpr size_t lanes = sizeof(Vec);
+    const auto load = [](const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const Vec*>(p)); };
+    const auto compare_mask = [](const Vec a, const Vec b, const Vec needle_a, const Vec needle_b)
+    {
+        const Vec eq = _mm256_and_si256(_mm256_cmpeq_epi8(a, needle_a), _mm256_cmpeq_epi8(b, needle_b));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+    };
+    const Vec first = _mm256_set1_epi8(static_cast<char>(pattern.AnchorByte()));
+    const Vec second = _mm256_set1_epi8(static_cast<char>(pattern.SecondAnchorByte()));
+#else
+    using Vec = __m128i;
+    constexpr size_t lanes = sizeof(Vec);
+    const auto load = [](const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const Vec*>(p)); };
+    const auto compare_mask = [](const Vec a, const Vec b, const Vec needle_a, const Vec needle_b)
+    {
+        const Vec eq = _mm_and_si128(_mm_cmpeq_epi8(a, needle_a), _mm_cmpeq_epi8(b, needle_b));
+        return static_cast<uint32_t>(_mm_movemask_epi8(eq));
+    };
+    const Vec first = _mm_set1_epi8(static_cast<char>(pattern.AnchorByte()));
+    const Vec second = _mm_set1_epi8(static_cast<char>(pattern.SecondAnchorByte()));
+#endif
+
+    const size_t first_offset = pattern.AnchorOffset();
+    const size_t second_offset = pattern.SecondAnchorOffset();
+
+    // Both anchor loads stay in bounds while start + size - 1 + lanes <= end.
+    const uint8_t* cur = begin;
+    if (static_cast<size_t>(end - begin) >= size - 1 + lanes)
+    {
+        const uint8_t* simd_end = end - (size - 1 + lanes);
+        for (; cur <= simd_end; cur += lanes)
+        {
+            uint32_t mask = compare_mask(load(cur + first_offset), load(cur + second_offset), first, second);
+            while (mask != 0)
+            {
+                const uint8_t* start = cur + std::countr_zero(mask);
+                if (pattern.Matches(start))
+                    return start;
+                mask &= mask - 1;
+            }
+        }
+    }
+
+    return FindScalar(cur, end, pattern);
+#else
+    return FindScalar(begin, end, pattern);
+#endif
+}
+
+/**
+ * @brief Ranges smaller than this are not worth spinning up threads for.
+ */
+static constexpr size_t MIN_PARALLEL_SIZE = 4 * 1024 * 1024;
+
+/**
+ * @brief Chunks handed out per thread. More chunks than threads keeps cores busy when some chunks finish early and
+ *        lets threads skip chunks above an already found match.
+ */
+static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+const uint8_t* PatternScanner::FindParallel(const uint8_t* begin, const uint8_t* end, const Pattern& pattern,
+                                            unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t size = pattern.Size();
+    if (begin == nullptr || end <= begin || static_cast<size_t>(end - begin) < size)
+        return nullptr;
+
+    const size_t range = static_cast<size_t>(end - begin);
+    if (threads == 1 || range < MIN_PARALLEL_SIZE)
+        return Find(begin, end, pattern);
+
+    const size_t chunk_count = threads * CHUNKS_PER_THREAD;
+    const size_t chunk_size = (range + chunk_count - 1) / chunk_count;
+
+    std::vector<const uint8_t*> results(chunk_count, nullptr);
+    std::atomic_size_t next_chunk{0};
+    // Lowest chunk known to contain a match. Chunks above it can't produce the final result.
+    std::atomic_size_t lowest_found{chunk_count};
+
+    const auto worker = [&]
+    {
+        for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+        {
+            if (chunk > lowest_found.load(std::memory_order_relaxed))
+                break;
+
+            const size_t chunk_begin = chunk * chunk_size;
+            if (chunk_begin >= range)
+                break;
+
+            // Extend each chunk by size - 1 bytes so matches that straddle the boundary are still found, while every
+            // match found starts inside this chunk.
+            const size_t chunk_end = std::min(range, chunk_begin + chunk_size + size - 1);
+
+            if (const uint8_t* match = Find(begin + chunk_begin, begin + chunk_end, pattern); match != nullptr)
+            {
+                results[chunk] = match;
+
+                size_t lowest = lowest_found.load(std::memory_order_relaxed);
+                while (chunk < lowest && !lowest_found.compare_exchange_weak(lowest, chunk))
+                {
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; i++)
+        pool.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : pool)
+        thread.join();
+
+    for (const uint8_t* match : results)
+    {
+        if (match != nullptr)
+            return match;
+    }
+
+    return nullptr;
+}
+
+std::vector<const uint8_t*> PatternScanner::FindAllParallel(const uint8_t* begin, const uint8_t* end,
+                                                            const Pattern& pattern, const size_t limit,
+                                                            unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t size = pattern.Size();
+    if (begin == nullptr || end <= begin || static_cast<size_t>(end - begin) < size)
+        return {};
+
+    const size_t range = static_cast<size_t>(end - begin);
+    const size_t chunk_count = threads == 1 || range < MIN_PARALLEL_SIZE ? 1 : threads * CHUNKS_PER_THREAD;
+    const size_t chunk_size = (range + chunk_count - 1) / chunk_count;
+
+    std::vector<std::vector<const uint8_t*>> results(chunk_count);
+    std::atomic_size_t next_chunk{0};
+
+    const auto worker = [&]
+    {
+        for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+        {
+            const size_t chunk_begin = chunk * chunk_size;
+            if (chunk_begin >= range)
+                break;
+
+            // See FindParallel, every match found starts inside this chunk.
+            const uint8_t* cur = begin + chunk_begin;
+            const uint8_t* chunk_end = begin + std::min(range, chunk_begin + chunk_size + size - 1);
+
+            std::vector<const uint8_t*>& matches = results[chunk];
+            while (limit == 0 || matches.size() < limit)
+            {
+                const uint8_t* match = Find(cur, chunk_end, pattern);
+                if (match == nullptr)
+                    break;
+
+                matches.push_back(match);
+                cur = match + 1;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    if (chunk_count > 1)
+    {
+        pool.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; i++)
+            pool.emplace_back(worker);
+    }
+
+    worker();
+
+    for (std::thread& thread : pool)
+        thread.join();
+
+    std::vector<const uint8_t*> merged;
+    for (const std::vector<const uint8_t*>& matches : results)
+    {
+        for (const uint8_t* match : matches)
+        {
+            if (limit != 0 && merged.size() == limit)
+                return merged;
+            merged.push_back(match);
+        }
+    }
+
+    return merged;
+}
+
+MultiPattern::MultiPattern(std::vector<Pattern> patterns)
+    : m_Patterns(std::move(patterns))
+{
+    for (size_t i = 0; i < m_Patterns.size(); i++)
+    {
+        const uint8_t anchor = m_Patterns[i].AnchorByte();
+        std::vector<uint32_t>& slot = m_Dispatch[anchor];
+        if (slot.empty())
+        {
+            m_AnchorBytes.push_back(anchor);
+
+            const uint8_t low = anchor & 0x0F;
+            const uint8_t high = anchor >> 4;
+            if (high < 8)
+                m_NibbleLow[low] |= static_cast<uint8_t>(1 << high);
+            else
+                m_NibbleHigh[low] |= static_cast<uint8_t>(1 << (high - 8));
+        }
+        slot.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+std::vector<const uint8_t*> PatternScanner::FindMany(const uint8_t* begin, const uint8_t* end,
+                                                     const MultiPattern& patterns)
+{
+    std::vector<const uint8_t*> results(patterns.Count(), nullptr);
+    size_t remaining = patterns.Count();
+
+    if (begin == nullptr || end <= begin || remaining == 0)
+        return results;
+
+    // Check every pattern anchored on this byte. Returns true once all patterns have been found.
+    const auto visit = [&](const uint8_t* anchor_pos)
+    {
+        for (const uint32_t index : patterns.Dispatch(*anchor_pos))
+        {
+            if (results[index] != nullptr)
+                continue;
+
+            const Pattern& pattern = patterns.Get(index);
+            if (static_cast<size_t>(anchor_pos - begin) < pattern.AnchorOffset())
+                continue;
+
+            const uint8_t* start = anchor_pos - pattern.AnchorOffset();
+            if (static_cast<size_t>(end - start) < pattern.Size() || !pattern.Matches(start))
+                continue;
+
+            results[index] = start;
+            remaining--;
+        }
+        return remaining == 0;
+    };
+
+    const uint8_t* cur = begin;
+
+#if defined(PATTERN_AVX2)
+    // Byte set membership through two nibble lookups, see MultiPattern::NibbleTableLow.
+    const auto broadcast = [](const std::array<uint8_t, 16>& table)
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+    };
+    const __m256i table_low = broadcast(patterns.NibbleTableLow());
+    const __m256i table_high = broadcast(patterns.NibbleTableHigh());
+    const __m256i bit_low = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i bit_high = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128,
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (; end - cur >= 32; cur += 32)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        const __m256i low = _mm256_and_si256(block, nibble);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+
+        const __m256i hit = _mm256_or_si256(
+            _mm256_and_si256(_mm256_shuffle_epi8(table_low, low), _mm256_shuffle_epi8(bit_low, high)),
+            _mm256_and_si256(_mm256_shuffle_epi8(table_high, low), _mm256_shuffle_epi8(bit_high, high)));
+
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, zero)));
+        while (mask != 0)
+        {
+            if (visit(cur + std::countr_zero(mask)))
+                return results;
+            mask &= mask - 1;
+        }
+    }
+#elif defined(PATTERN_SSE2)
+    // No byte shuffle in SSE2, compare against each distinct anchor instead.
+    const std::vector<uint8_t>& anchors = patterns.AnchorBytes();
+    __m128i needles[256];
+    for (size_t i = 0; i < anchors.size(); i++)
+        needles[i] = _mm_set1_epi8(static_cast<char>(anchors[i]));
+
+    for (; end - cur >= 16; cur += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        __m128i hit = _mm_setzero_si128();
+        for (size_t i = 0; i < anchors.size(); i++)
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[i]));
+
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        while (mask != 0)
+        {
+            if (visit(cur + std::countr_zero(mask)))
+                return results;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; cur < end; cur++)
+    {
+        if (!patterns.Dispatch(*cur).empty() && visit(cur))
+            break;
+    }
+
+    return results;
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * This header and its translation unit do not depend on Windows or Lua so that the scanning core can be built and
+ * tested on any platform against arbitrary in-memory buffers.
+*/
+
+/**
+ * @brief An IDA-style signature compiled into a byte and mask vector.
+ */
+class Pattern final
+{
+public:
+    /**
+     * @brief Compile an IDA-style signature such as "48 8B 05 ? ? ? ? 48 85 C0".
+     * @return The compiled pattern, or an empty optional if the signature is malformed or has no concrete bytes
+     */
+    static std::optional<Pattern> Compile(std::string_view signature);
+
+    /**
+     * @brief Build a pattern from raw bytes. Every byte is concrete.
+     */
+    static Pattern FromBytes(const uint8_t* bytes, size_t size);
+
+    /**
+     * @return The pattern in canonical IDA-style form, e.g. "48 8B 05 ? ? ? ?".
+     */
+    std::string ToString() const;
+
+    /**
+     * @return The number of bytes, including wildcards, the pattern spans.
+     */
+    size_t Size() const
+    {
+        return m_Bytes.size();
+    }
+
+    /**
+     * @brief Compare the pattern against memory. The caller must ensure Size() bytes are readable at data.
+     */
+    bool Matches(const uint8_t* data) const;
+
+    const std::vector<uint8_t>& Bytes() const
+    {
+        return m_Bytes;
+    }
+
+    /**
+     * @return Per-byte mask, 0xFF for concrete bytes and 0x00 for wildcards.
+     */
+    const std::vector<uint8_t>& Mask() const
+    {
+        return m_Mask;
+    }
+
+    /**
+     * @return Offset of the rarest concrete byte. Scanners search for this byte first.
+     */
+    size_t AnchorOffset() const
+    {
+        return m_Anchor;
+    }
+
+    uint8_t AnchorByte() const
+    {
+        return m_Bytes[m_Anchor];
+    }
+
+    /**
+     * @return Offset of the second rarest concrete byte, or the anchor itself if the pattern has only one.
+     */
+    size_t SecondAnchorOffset() const
+    {
+        return m_SecondAnchor;
+    }
+
+    uint8_t SecondAnchorByte() const
+    {
+        return m_Bytes[m_SecondAnchor];
+    }
+
+private:
+    Pattern() = default;
+
+    /**
+     * @brief Pick the anchor bytes using a static table of how common each byte is in x64 code.
+     */
+    void SelectAnchors();
+
+    std::vector<uint8_t> m_Bytes{};
+    std::vector<uint8_t> m_Mask{};
+    size_t m_Anchor{0};
+    size_t m_SecondAnchor{0};
+};
+
+/**
+ * @brief A set of compiled patterns that can be searched for in a single pass. Patterns are dispatched on their
+ *        anchor byte so each position in memory is only inspected once regardless of how many patterns there are.
+ */
+class MultiPattern final
+{
+public:
+    explicit MultiPattern(std::vector<Pattern> patterns);
+
+    size_t Count() const
+    {
+        return m_Patterns.size();
+    }
+
+    const Pattern& Get(const size_t index) const
+    {
+        return m_Patterns[index];
+    }
+
+    /**
+     * @return Indices of the patterns whose anchor is the given byte.
+     */
+    const std::vector<uint32_t>& Dispatch(const uint8_t byte) const
+    {
+        return m_Dispatch[byte];
+    }
+
+    /**
+     * @return Distinct anchor bytes over all patterns.
+     */
+    const std::vector<uint8_t>& AnchorBytes() const
+    {
+        return m_AnchorBytes;
+    }
+
+    /**
+     * @brief Nibble lookup tables for SIMD set membership. Indexed by the low nibble, each entry has bit N set when
+     *        an anchor byte with high nibble N (or N + 8 for the second table) exists.
+     */
+    const std::array<uint8_t, 16>& NibbleTableLow() const
+    {
+        return m_NibbleLow;
+    }
+
+    const std::array<uint8_t, 16>& NibbleTableHigh() const
+    {
+        return m_NibbleHigh;
+    }
+
+private:
+    std::vector<Pattern> m_Patterns;
+    std::array<std::vector<uint32_t>, 256> m_Dispatch{};
+    std::vector<uint8_t> m_AnchorBytes{};
+    std::array<uint8_t, 16> m_NibbleLow{};
+    std::array<uint8_t, 16> m_NibbleHigh{};
+};
+
+/**
+ * @brief Scans memory for compiled patterns using SSE2/AVX2 when available.
+ */
+class PatternScanner final
+{
+public:
+    PatternScanner() = delete;
+
+    /**
+     * @brief Find the first match of a pattern that lies entirely within [begin, end).
+     * @return The address of the match or nullptr if it could not be found
+     */
+    static const uint8_t* Find(const uint8_t* begin, const uint8_t* end, const Pattern& pattern);
+
+    /**
+     * @brief Same as Find but splits the range into overlapping chunks scanned by one thread per hardware thread.
+     *        The lowest match always wins so the result is identical to Find.
+     * @param threads Number of threads to use, 0 to use one per hardware thread
+     */
+    static const uint8_t* FindParallel(const uint8_t* begin, const uint8_t* end, const Pattern& pattern,
+                                       unsigned threads = 0);
+
+    /**
+     * @brief Find every match of a pattern using one thread per hardware thread.
+     * @param limit Maximum number of matches to return, 0 for no limit
+     * @return Matches in ascending address order, identical to calling Find repeatedly
+     */
+    static std::vector<const uint8_t*> FindAllParallel(const uint8_t* begin, const uint8_t* end,
+                                                       const Pattern& pattern, size_t limit = 0,
+                                                       unsigned threads = 0);
+
+    /**
+     * @brief Find the first match of every pattern in a set with a single pass over [begin, end).
+     * @return The address of the first match of each pattern, in the same order as the set. Patterns that could not
+     *         be found are nullptr.
+     */
+    static std::vector<const uint8_t*> FindMany(const uint8_t* begin, const uint8_t* end, const MultiPattern& patterns);
+};
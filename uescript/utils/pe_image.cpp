@@ -0,0 +1,310 @@
+#include "pe_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+std::optional<PEImage> PEImage::FromLoaded(const uint8_t* base)
+{
+    if (base == nullptr)
+        return {};
+
+    const auto dos = reinterpret_cast<const pe::DosHeader*>(base);
+    if (dos->e_magic != pe::DOS_SIGNATURE || dos->e_lfanew <= 0)
+        return {};
+
+    const auto nt = reinterpret_cast<const pe::NtHeaders64*>(base + dos->e_lfanew);
+    if (nt->Signature != pe::NT_SIGNATURE || nt->OptionalHeader.Magic != pe::OPTIONAL_HEADER_MAGIC_64)
+        return {};
+
+    PEImage image;
+    image.m_Layout = Layout::Loaded;
+    image.m_Base = base;
+    image.m_Size = nt->OptionalHeader.SizeOfImage;
+    image.m_Headers = nt;
+
+    if (!image.ParseSections())
+        return {};
+
+    return image;
+}
+
+std::optional<PEImage> PEImage::FromFile(const uint8_t* data, const size_t size)
+{
+    if (data == nullptr || size < sizeof(pe::DosHeader))
+        return {};
+
+    const auto dos = reinterpret_cast<const pe::DosHeader*>(data);
+    if (dos->e_magic != pe::DOS_SIGNATURE || dos->e_lfanew <= 0)
+        return {};
+
+    // Unlike a loaded image, nothing guarantees the headers are actually there.
+    if (static_cast<size_t>(dos->e_lfanew) + sizeof(pe::NtHeaders64) > size)
+        return {};
+
+    const auto nt = reinterpret_cast<const pe::NtHeaders64*>(data + dos->e_lfanew);
+    if (nt->Signature != pe::NT_SIGNATURE || nt->OptionalHeader.Magic != pe::OPTIONAL_HEADER_MAGIC_64)
+        return {};
+
+    PEImage image;
+    image.m_Layout = Layout::File;
+    image.m_Base = data;
+    image.m_Size = size;
+    image.m_Headers = nt;
+
+    if (!image.ParseSections())
+        return {};
+
+    return image;
+}
+
+bool PEImage::ParseSections()
+{
+    // Section headers follow the optional header, whose size is given by the file header.
+    const auto table = reinterpret_cast<const uint8_t*>(&m_Headers->OptionalHeader) + m_Headers->FileHeader.
+        SizeOfOptionalHeader;
+    const uint16_t count = m_Headers->FileHeader.NumberOfSections;
+
+    if (static_cast<size_t>(table - m_Base) + count * sizeof(pe::SectionHeader) > m_Size)
+        return false;
+
+    const auto sections = reinterpret_cast<const pe::SectionHeader*>(table);
+
+    m_Sections.reserve(count);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const pe::SectionHeader& header = sections[i];
+        m_Sections.push_back({
+            std::string(header.Name, strnlen(header.Name, sizeof(header.Name))),
+            header.VirtualAddress,
+            header.VirtualSize,
+            header.Characteristics,
+            &header
+        });
+    }
+
+    return true;
+}
+
+const PEImage::Section* PEImage::FindSection(const std::string_view name) const
+{
+    for (const Section& section : m_Sections)
+    {
+        if (section.Name == name)
+            return &section;
+    }
+    return nullptr;
+}
+
+const PEImage::Section* PEImage::SectionAtRva(const uint32_t rva) const
+{
+    for (const Section& section : m_Sections)
+    {
+        // Some linkers leave VirtualSize as 0, in which case the raw size describes the section.
+        const uint32_t size = std::max(section.VirtualSize, section.Header->SizeOfRawData);
+        if (rva >= section.Rva && rva - section.Rva < size)
+            return &section;
+    }
+    return nullptr;
+}
+
+std::pair<const uint8_t*, size_t> PEImage::ResolveRva(const uint32_t rva) const
+{
+    if (m_Layout == Layout::Loaded)
+    {
+        if (rva >= m_Size)
+            return {nullptr, 0};
+        return {m_Base + rva, m_Size - rva};
+    }
+
+    // Headers are stored at the start of the file, the same as when loaded.
+    if (rva < m_Headers->OptionalHeader.SizeOfHeaders)
+    {
+        const size_t headers = std::min<size_t>(m_Headers->OptionalHeader.SizeOfHeaders, m_Size);
+        if (rva >= headers)
+            return {nullptr, 0};
+        return {m_Base + rva, headers - rva};
+    }
+
+    const Section* section = SectionAtRva(rva);
+    if (section == nullptr)
+        return {nullptr, 0};
+
+    // Uninitialized data (the tail past SizeOfRawData) only exists in memory.
+    const uint32_t delta = rva - section->Rva;
+    if (delta >= section->Header->SizeOfRawData)
+        return {nullptr, 0};
+
+    const size_t offset = static_cast<size_t>(section->Header->PointerToRawData) + delta;
+    if (offset >= m_Size)
+        return {nullptr, 0};
+
+    return {m_Base + offset, std::min<size_t>(section->Header->SizeOfRawData - delta, m_Size - offset)};
+}
+
+const uint8_t* PEImage::RvaToPointer(const uint32_t rva, const size_t size) const
+{
+    const auto [pointer, available] = ResolveRva(rva);
+    return size <= available ? pointer : nullptr;
+}
+
+std::optional<uint32_t> PEImage::PointerToRva(const uint8_t* pointer) const
+{
+    if (pointer < m_Base || pointer >= m_Base + m_Size)
+        return {};
+
+    const auto offset = static_cast<size_t>(pointer - m_Base);
+    if (m_Layout == Layout::Loaded || offset < m_Headers->OptionalHeader.SizeOfHeaders)
+        return static_cast<uint32_t>(offset);
+
+    for (const Section& section : m_Sections)
+    {
+        const size_t raw = section.Header->PointerToRawData;
+        if (offset >= raw && offset - raw < section.Header->SizeOfRawData)
+            return static_cast<uint32_t>(section.Rva + (offset - raw));
+    }
+    return {};
+}
+
+std::pair<const uint8_t*, const uint8_t*> PEImage::SectionRange(const Section& section) const
+{
+    if (m_Layout == Layout::Loaded)
+    {
+        // A malformed header can place the section past the end of the image.
+        if (section.Rva >= m_Size)
+            return {m_Base, m_Base};
+
+        // Same sizing as SectionAtRva, some linkers leave VirtualSize as 0. Never past the end of the image.
+        const uint8_t* begin = m_Base + section.Rva;
+        const size_t size = std::min<size_t>(std::max(section.VirtualSize, section.Header->SizeOfRawData),
+                                             m_Size - section.Rva);
+        return {begin, begin + size};
+    }
+
+    // On disk only the raw data exists, which may be shorter (uninitialized data) or longer (alignment padding).
+    const size_t offset = std::min<size_t>(section.Header->PointerToRawData, m_Size);
+    size_t size = std::min<size_t>(section.Header->SizeOfRawData, m_Size - offset);
+    if (section.VirtualSize != 0)
+        size = std::min<size_t>(size, section.VirtualSize);
+
+    const uint8_t* begin = m_Base + offset;
+    return {begin, begin + size};
+}
+
+std::pair<const uint8_t*, const uint8_t*> PEImage::CodeRange() const
+{
+    const pe::OptionalHeader64& optional = m_Headers->OptionalHeader;
+
+    if (m_Layout == Layout::Loaded)
+    {
+        const uint8_t* begin = m_Base + optional.BaseOfCode;
+        return {begin, begin + optional.SizeOfCode};
+    }
+
+    const Section* section = SectionAtRva(optional.BaseOfCode);
+    if (section == nullptr)
+        return {m_Base, m_Base};
+
+    const auto [section_begin, section_end] = SectionRange(*section);
+    const uint8_t* begin = std::min(section_begin + (optional.BaseOfCode - section->Rva), section_end);
+    const uint8_t* end = std::min(begin + optional.SizeOfCode, section_end);
+    return {begin, end};
+}
+
+std::span<const pe::RuntimeFunction> PEImage::RuntimeFunctions() const
+{
+    const pe::OptionalHeader64& optional = m_Headers->OptionalHeader;
+    if (optional.NumberOfRvaAndSizes <= pe::DIRECTORY_EXCEPTION)
+        return {};
+
+    const pe::DataDirectory& directory = optional.DataDirectories[pe::DIRECTORY_EXCEPTION];
+    const auto [data, available] = ResolveRva(directory.VirtualAddress);
+    if (directory.VirtualAddress == 0 || data == nullptr)
+        return {};
+
+    // Never trust the size to stay inside the data we have.
+    const size_t count = std::min<size_t>(directory.Size, available) / sizeof(pe::RuntimeFunction);
+    return {reinterpret_cast<const pe::RuntimeFunction*>(data), count};
+}
+
+const pe::RuntimeFunction* PEImage::FindRuntimeFunction(const uint32_t rva) const
+{
+    const std::span<const pe::RuntimeFunction> functions = RuntimeFunctions();
+
+    // First entry that begins after the RVA, the one before it is the only candidate.
+    const auto it = std::upper_bound(functions.begin(), functions.end(), rva,
+                                     [](const uint32_t value, const pe::RuntimeFunction& function)
+                                     {
+                                         return value < function.BeginAddress;
+                                     });
+    if (it == functions.begin())
+        return nullptr;
+
+    const pe::RuntimeFunction& function = *std::prev(it);
+    return rva < function.EndAddress ? &function : nullptr;
+}
+
+const pe::RuntimeFunction* PEImage::PrimaryRuntimeFunction(const pe::RuntimeFunction* function) const
+{
+    // Chains are short, the limit only guards against malformed images.
+    for (int depth = 0; function != nullptr && depth < 32; depth++)
+    {
+        const auto unwind = reinterpret_cast<const pe::UnwindInfo*>(
+            RvaToPointer(function->UnwindData, sizeof(pe::UnwindInfo)));
+        if (unwind == nullptr || ((unwind->VersionAndFlags >> 3) & pe::UNWIND_CHAININFO) == 0)
+            return function;
+
+        // The chained entry follows the unwind codes, which are padded to an even count.
+        const size_t codes = (unwind->CountOfCodes + 1u) & ~1u;
+        const uint32_t chained_rva = function->UnwindData + static_cast<uint32_t>(sizeof(pe::UnwindInfo) + codes * 2);
+        const auto chained = reinterpret_cast<const pe::RuntimeFunction*>(
+            RvaToPointer(chained_rva, sizeof(pe::RuntimeFunction)));
+        if (chained == nullptr)
+            return function;
+
+        // The chained copy lives in .xdata, return the matching entry from the directory itself.
+        const pe::RuntimeFunction* entry = FindRuntimeFunction(chained->BeginAddress);
+        function = entry != nullptr ? entry : chained;
+    }
+    return function;
+}
+
+std::vector<uint32_t> PEImage::Relocations(const uint32_t begin, const uint32_t end) const
+{
+    std::vector<uint32_t> result;
+
+    const pe::OptionalHeader64& optional = m_Headers->OptionalHeader;
+    if (optional.NumberOfRvaAndSizes <= pe::DIRECTORY_BASERELOC)
+        return result;
+
+    const pe::DataDirectory& directory = optional.DataDirectories[pe::DIRECTORY_BASERELOC];
+    const auto [data, available] = ResolveRva(directory.VirtualAddress);
+    if (directory.VirtualAddress == 0 || data == nullptr)
+        return result;
+
+    const size_t size = std::min<size_t>(directory.Size, available);
+    for (size_t offset = 0; offset + sizeof(pe::BaseRelocation) <= size;)
+    {
+        const auto block = reinterpret_cast<const pe::BaseRelocation*>(data + offset);
+        if (block->SizeOfBlock < sizeof(pe::BaseRelocation) || offset + block->SizeOfBlock > size)
+            break;
+
+        // Each block covers one 4K page, skip pages that can't contain anything in range.
+        if (block->VirtualAddress < end && block->VirtualAddress + 0x1000 > begin)
+        {
+            const auto entries = reinterpret_cast<const uint16_t*>(block + 1);
+            const size_t count = (block->SizeOfBlock - sizeof(pe::BaseRelocation)) / sizeof(uint16_t);
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint32_t rva = block->VirtualAddress + (entries[i] & 0x0FFF);
+                if ((entries[i] >> 12) == pe::RELOCATION_DIR64 && rva >= begin && rva < end)
+                    result.push_back(rva);
+            }
+        }
+
+        offset += block->SizeOfBlock;
+    }
+
+    std::ranges::sort(result);
+    return result;
+}
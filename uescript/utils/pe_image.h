@@ -0,0 +1,273 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+ * Minimal PE32+ parser. Like pattern.h, this has no Windows dependency, so the structures below mirror the parts of
+ * winnt.h we need.
+*/
+
+namespace pe
+{
+    constexpr uint16_t DOS_SIGNATURE = 0x5A4D; // MZ
+    constexpr uint32_t NT_SIGNATURE = 0x00004550; // PE\0\0
+    constexpr uint16_t OPTIONAL_HEADER_MAGIC_64 = 0x20B;
+
+    struct DosHeader
+    {
+        uint16_t e_magic;
+        uint16_t _pad[29];
+        int32_t e_lfanew;
+    };
+    static_assert(sizeof(DosHeader) == 0x40);
+
+    struct FileHeader
+    {
+        uint16_t Machine;
+        uint16_t NumberOfSections;
+        uint32_t TimeDateStamp;
+        uint32_t PointerToSymbolTable;
+        uint32_t NumberOfSymbols;
+        uint16_t SizeOfOptionalHeader;
+        uint16_t Characteristics;
+    };
+    static_assert(sizeof(FileHeader) == 0x14);
+
+    struct DataDirectory
+    {
+        uint32_t VirtualAddress;
+        uint32_t Size;
+    };
+
+    struct OptionalHeader64
+    {
+        uint16_t Magic;
+        uint8_t MajorLinkerVersion;
+        uint8_t MinorLinkerVersion;
+        uint32_t SizeOfCode;
+        uint32_t SizeOfInitializedData;
+        uint32_t SizeOfUninitializedData;
+        uint32_t AddressOfEntryPoint;
+        uint32_t BaseOfCode;
+        uint64_t ImageBase;
+        uint32_t SectionAlignment;
+        uint32_t FileAlignment;
+        uint16_t _versions[6];
+        uint32_t Win32VersionValue;
+        uint32_t SizeOfImage;
+        uint32_t SizeOfHeaders;
+        uint32_t CheckSum;
+        uint16_t Subsystem;
+        uint16_t DllCharacteristics;
+        uint64_t _stack_heap[4];
+        uint32_t LoaderFlags;
+        uint32_t NumberOfRvaAndSizes;
+        DataDirectory DataDirectories[16];
+    };
+    static_assert(sizeof(OptionalHeader64) == 0xF0);
+
+    struct NtHeaders64
+    {
+        uint32_t Signature;
+        pe::FileHeader FileHeader;
+        pe::OptionalHeader64 OptionalHeader;
+    };
+
+    struct SectionHeader
+    {
+        char Name[8];
+        uint32_t VirtualSize;
+        uint32_t VirtualAddress;
+        uint32_t SizeOfRawData;
+        uint32_t PointerToRawData;
+        uint32_t PointerToRelocations;
+        uint32_t PointerToLinenumbers;
+        uint16_t NumberOfRelocations;
+        uint16_t NumberOfLinenumbers;
+        uint32_t Characteristics;
+    };
+    static_assert(sizeof(SectionHeader) == 0x28);
+
+    constexpr uint32_t SECTION_CNT_CODE = 0x00000020;
+    constexpr uint32_t SECTION_MEM_EXECUTE = 0x20000000;
+
+    constexpr size_t DIRECTORY_EXCEPTION = 3;
+
+    /**
+     * @brief An entry of the x64 exception directory (.pdata). Entries are sorted by BeginAddress.
+     */
+    struct RuntimeFunction
+    {
+        uint32_t BeginAddress;
+        uint32_t EndAddress;
+        uint32_t UnwindData;
+    };
+    static_assert(sizeof(RuntimeFunction) == 0xC);
+
+    struct UnwindInfo
+    {
+        uint8_t VersionAndFlags;
+        uint8_t SizeOfProlog;
+        uint8_t CountOfCodes;
+        uint8_t FrameRegisterAndOffset;
+        // uint16_t UnwindCodes[CountOfCodes rounded up to even], then a RuntimeFunction if UNWIND_CHAININFO is set.
+    };
+
+    constexpr uint8_t UNWIND_CHAININFO = 0x4;
+
+    constexpr size_t DIRECTORY_BASERELOC = 5;
+
+    /**
+     * @brief Header of a block of base relocations for one 4K page, followed by uint16_t entries of
+     *        (type << 12 | page offset).
+     */
+    struct BaseRelocation
+    {
+        uint32_t VirtualAddress;
+        uint32_t SizeOfBlock;
+    };
+
+    constexpr uint16_t RELOCATION_DIR64 = 10;
+}
+
+/**
+ * @brief A view of a PE32+ image, either mapped by the loader or read straight from disk.
+ */
+class PEImage final
+{
+public:
+    enum class Layout
+    {
+        /** Sections are at their RVAs, as mapped by the loader **/
+        Loaded,
+        /** Sections are at their raw file offsets, as stored on disk **/
+        File
+    };
+
+    struct Section
+    {
+        std::string Name;
+        uint32_t Rva;
+        uint32_t VirtualSize;
+        uint32_t Characteristics;
+        /** Raw section header, e.g. for hashing **/
+        const pe::SectionHeader* Header;
+    };
+
+    /**
+     * @brief Parse an image that has been mapped by the loader, i.e. sections are at their RVAs.
+     * @return The parsed image or an empty optional if the headers are not a valid PE32+ image
+     */
+    static std::optional<PEImage> FromLoaded(const uint8_t* base);
+
+    /**
+     * @brief Parse the contents of a PE file, e.g. a memory-mapped executable. Every header is bounds-checked against
+     *        the file size.
+     * @return The parsed image or an empty optional if the file is not a valid PE32+ image
+     */
+    static std::optional<PEImage> FromFile(const uint8_t* data, size_t size);
+
+    const uint8_t* Base() const
+    {
+        return m_Base;
+    }
+
+    Layout GetLayout() const
+    {
+        return m_Layout;
+    }
+
+    const pe::NtHeaders64& Headers() const
+    {
+        return *m_Headers;
+    }
+
+    const std::vector<Section>& Sections() const
+    {
+        return m_Sections;
+    }
+
+    /**
+     * @return The first section with the given name (e.g. ".rdata") or nullptr.
+     */
+    const Section* FindSection(std::string_view name) const;
+
+    /**
+     * @return A pointer to the size bytes at an RVA, or nullptr unless all of them are inside the image and, for a
+     *         file, inside the raw data of the headers or of one section.
+     */
+    const uint8_t* RvaToPointer(uint32_t rva, size_t size = 1) const;
+
+    /**
+     * @brief The inverse of RvaToPointer.
+     * @return The RVA of a pointer into the image, or an empty optional if it does not point into it
+     */
+    std::optional<uint32_t> PointerToRva(const uint8_t* pointer) const;
+
+    /**
+     * @brief Resolve the [begin, end) range of a section's data.
+     */
+    std::pair<const uint8_t*, const uint8_t*> SectionRange(const Section& section) const;
+
+    /**
+     * @return The entries of the exception directory that lie inside the data, empty if there is none.
+     */
+    std::span<const pe::RuntimeFunction> RuntimeFunctions() const;
+
+    /**
+     * @brief Binary search the exception directory for the entry containing an RVA. Leaf functions have no entry.
+     * @return The entry or nullptr
+     */
+    const pe::RuntimeFunction* FindRuntimeFunction(uint32_t rva) const;
+
+    /**
+     * @brief Follow chained unwind info back to the entry of the function a chunk belongs to. Compilers split cold
+     *        paths of a function into separate chunks which chain to the primary entry.
+     * @return The primary entry, which is the entry itself for an unchained function
+     */
+    const pe::RuntimeFunction* PrimaryRuntimeFunction(const pe::RuntimeFunction* function) const;
+
+    /**
+     * @return The RVAs of the 64-bit absolute addresses in [begin, end) that the loader rebases, in address order.
+     */
+    std::vector<uint32_t> Relocations(uint32_t begin, uint32_t end) const;
+
+    /**
+     * @brief Resolve the [begin, end) range described by BaseOfCode and SizeOfCode. For a file, this is clamped to the
+     *        raw data of the section BaseOfCode is in.
+     */
+    std::pair<const uint8_t*, const uint8_t*> CodeRange() const;
+
+private:
+    PEImage() = default;
+
+    /**
+     * @brief Read the section table that follows the optional header.
+     * @return false if the table extends past the end of the data
+     */
+    bool ParseSections();
+
+    /**
+     * @return The section containing an RVA, or nullptr.
+     */
+    const Section* SectionAtRva(uint32_t rva) const;
+
+    /**
+     * @return A pointer to the data at an RVA and how many bytes can be read from it without leaving the headers or
+     *         the section it is in, or nullptr and 0.
+     */
+    std::pair<const uint8_t*, size_t> ResolveRva(uint32_t rva) const;
+
+    Layout m_Layout{Layout::Loaded};
+    const uint8_t* m_Base{nullptr};
+    /** SizeOfImage for a loaded image, the file size otherwise **/
+    size_t m_Size{0};
+    const pe::NtHeaders64* m_Headers{nullptr};
+    std::vector<Section> m_Sections{};
+};
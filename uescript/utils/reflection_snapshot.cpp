@@ -0,0 +1,207 @@
+#include "reflection_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ranges>
+
+static constexpr char SNAPSHOT_MAGIC[8] = {'U', 'E', 'S', 'R', 'E', 'F', 'L', '\0'};
+
+static uint64_t AlignUp(const uint64_t value)
+{
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+void ReflectionSnapshotWriter::AddProperty(const std::string_view outer, const std::string_view name,
+                                           const int32_t offset, const int32_t size)
+{
+    m_Classes[m_Strings.Intern(outer)].Properties.push_back({m_Strings.Intern(name), offset, size});
+}
+
+void ReflectionSnapshotWriter::AddFunction(const std::string_view outer, const std::string_view name,
+                                           const int32_t object_index)
+{
+    m_Classes[m_Strings.Intern(outer)].Functions.push_back({m_Strings.Intern(name), object_index});
+}
+
+bool ReflectionSnapshotWriter::Save(const std::filesystem::path& path, const ModuleIdentity& module) const
+{
+    std::vector<uint32_t> string_offsets(m_Strings.Size());
+    uint32_t strings_size = 0;
+    for (size_t id = 0; id < m_Strings.Size(); id++)
+    {
+        string_offsets[id] = strings_size;
+        strings_size += static_cast<uint32_t>(m_Strings.Get(static_cast<uint32_t>(id)).size() + 1);
+    }
+
+    // The module name is appended after the pool unless a class happens to have the same name.
+    const std::optional<uint32_t>& module_id = m_Strings.Find(module.Name);
+    const uint32_t module_name = module_id.has_value() ? string_offsets[module_id.value()] : strings_size;
+    if (!module_id.has_value())
+        strings_size += static_cast<uint32_t>(module.Name.size() + 1);
+
+    std::vector<uint32_t> order;
+    order.reserve(m_Classes.size());
+    for (const uint32_t outer : m_Classes | std::views::keys)
+        order.push_back(outer);
+
+    std::ranges::sort(order, [this](const uint32_t a, const uint32_t b)
+    {
+        return m_Strings.Get(a) < m_Strings.Get(b);
+    });
+
+    std::vector<SnapshotClass> classes;
+    std::vector<SnapshotProperty> properties;
+    std::vector<SnapshotFunction> functions;
+    classes.reserve(order.size());
+    for (const uint32_t outer : order)
+    {
+        const PendingClass& pending = m_Classes.at(outer);
+        classes.push_back({
+            string_offsets[outer], static_cast<uint32_t>(properties.size()),
+            static_cast<uint32_t>(pending.Properties.size()), static_cast<uint32_t>(functions.size()),
+            static_cast<uint32_t>(pending.Functions.size())
+        });
+
+        for (const SnapshotProperty& property : pending.Properties)
+            properties.push_back({string_offsets[property.Name], property.Offset, property.Size});
+
+        for (const SnapshotFunction& function : pending.Functions)
+            functions.push_back({string_offsets[function.Name], function.ObjectIndex});
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.Magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.Version = ReflectionSnapshot::VERSION;
+    header.TimeDateStamp = module.TimeDateStamp;
+    header.SizeOfImage = module.SizeOfImage;
+    header.ModuleName = module_name;
+    header.TextHash = module.TextHash;
+    header.ClassCount = static_cast<uint32_t>(classes.size());
+    header.PropertyCount = static_cast<uint32_t>(properties.size());
+    header.FunctionCount = static_cast<uint32_t>(functions.size());
+    header.StringsSize = strings_size;
+    header.Classes = AlignUp(sizeof(SnapshotHeader));
+    header.Properties = AlignUp(header.Classes + classes.size() * sizeof(SnapshotClass));
+    header.Functions = AlignUp(header.Properties + properties.size() * sizeof(SnapshotProperty));
+    header.Strings = AlignUp(header.Functions + functions.size() * sizeof(SnapshotFunction));
+
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        const auto write_at = [&out](const uint64_t offset, const void* data, const size_t size)
+        {
+            // Pad up to the aligned offset.
+            static constexpr char zeros[8]{};
+            out.write(zeros, static_cast<std::streamsize>(offset - static_cast<uint64_t>(out.tellp())));
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        };
+
+        write_at(0, &header, sizeof(header));
+        write_at(header.Classes, classes.data(), classes.size() * sizeof(SnapshotClass));
+        write_at(header.Properties, properties.data(), properties.size() * sizeof(SnapshotProperty));
+        write_at(header.Functions, functions.data(), functions.size() * sizeof(SnapshotFunction));
+        write_at(header.Strings, nullptr, 0);
+        for (size_t id = 0; id < m_Strings.Size(); id++)
+        {
+            const std::string_view string = m_Strings.Get(static_cast<uint32_t>(id));
+            out.write(string.data(), static_cast<std::streamsize>(string.size() + 1));
+        }
+
+        if (!module_id.has_value())
+            out.write(module.Name.c_str(), static_cast<std::streamsize>(module.Name.size() + 1));
+
+        if (!out)
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+std::optional<ReflectionSnapshot> ReflectionSnapshot::Open(const std::filesystem::path& path,
+                                                           const ModuleIdentity& module)
+{
+    std::optional<MappedFile> file = MappedFile::Open(path);
+    if (!file.has_value() || file->Size() < sizeof(SnapshotHeader))
+        return {};
+
+    const uint8_t* data = file->Data();
+    const uint64_t size = file->Size();
+
+    SnapshotHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.Magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.Version != VERSION)
+        return {};
+
+    const auto in_bounds = [size](const uint64_t offset, const uint64_t count, const uint64_t element_size)
+    {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / element_size;
+    };
+
+    if (!in_bounds(header.Classes, header.ClassCount, sizeof(SnapshotClass)) ||
+        !in_bounds(header.Properties, header.PropertyCount, sizeof(SnapshotProperty)) ||
+        !in_bounds(header.Functions, header.FunctionCount, sizeof(SnapshotFunction)) ||
+        !in_bounds(header.Strings, header.StringsSize, 1) || header.StringsSize == 0 ||
+        data[header.Strings + header.StringsSize - 1] != '\0')
+    {
+        return {};
+    }
+
+    ReflectionSnapshot snapshot(std::move(file.value()));
+    snapshot.m_Classes = {reinterpret_cast<const SnapshotClass*>(data + header.Classes), header.ClassCount};
+    snapshot.m_Properties = {reinterpret_cast<const SnapshotProperty*>(data + header.Properties), header.PropertyCount};
+    snapshot.m_Functions = {reinterpret_cast<const SnapshotFunction*>(data + header.Functions), header.FunctionCount};
+    snapshot.m_Strings = {reinterpret_cast<const char*>(data + header.Strings), header.StringsSize};
+
+    const ModuleIdentity written{
+        std::string(snapshot.String(header.ModuleName)), header.TimeDateStamp, header.SizeOfImage, header.TextHash
+    };
+    if (written.Name != module.Name || !written.SameBuild(module))
+        return {};
+
+    return snapshot;
+}
+
+const SnapshotClass* ReflectionSnapshot::FindClass(const std::string_view name) const
+{
+    const auto it = std::ranges::lower_bound(m_Classes, name, {}, [this](const SnapshotClass& klass)
+    {
+        return String(klass.Name);
+    });
+
+    if (it == m_Classes.end() || String(it->Name) != name)
+        return nullptr;
+
+    return &*it;
+}
+
+std::span<const SnapshotProperty> ReflectionSnapshot::Properties(const SnapshotClass& klass) const
+{
+    if (klass.FirstProperty > m_Properties.size() || klass.PropertyCount > m_Properties.size() - klass.FirstProperty)
+        return {};
+
+    return m_Properties.subspan(klass.FirstProperty, klass.PropertyCount);
+}
+
+std::span<const SnapshotFunction> ReflectionSnapshot::Functions(const SnapshotClass& klass) const
+{
+    if (klass.FirstFunction > m_Functions.size() || klass.FunctionCount > m_Functions.size() - klass.FirstFunction)
+        return {};
+
+    return m_Functions.subspan(klass.FirstFunction, klass.FunctionCount);
+}
+
+std::string_view ReflectionSnapshot::String(const uint32_t offset) const
+{
+    if (offset >= m_Strings.size())
+        return {};
+
+    // The block ends with a terminator, so every string in it is terminated.
+    return m_Strings.data() + offset;
+}
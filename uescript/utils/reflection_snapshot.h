@@ -0,0 +1,150 @@
+#pragma once
+#include "mapped_file.h"
+#include "signature_cache.h"
+#include "string_pool.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Like pattern.h, this does not depend on Windows or Lua.
+ *
+ * File layout, little-endian, every table 8-byte aligned:
+ *   SnapshotHeader
+ *   SnapshotClass[ClassCount]          sorted by name
+ *   SnapshotProperty[PropertyCount]    grouped by class
+ *   SnapshotFunction[FunctionCount]    grouped by class
+ *   Strings                            null-terminated, names are offsets into this block
+*/
+
+struct SnapshotHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t TimeDateStamp;
+    uint32_t SizeOfImage;
+    uint32_t ModuleName;
+    uint64_t TextHash;
+    uint32_t ClassCount;
+    uint32_t PropertyCount;
+    uint32_t FunctionCount;
+    uint32_t StringsSize;
+    uint64_t Classes;
+    uint64_t Properties;
+    uint64_t Functions;
+    uint64_t Strings;
+};
+
+struct SnapshotClass
+{
+    uint32_t Name;
+    uint32_t FirstProperty;
+    uint32_t PropertyCount;
+    uint32_t FirstFunction;
+    uint32_t FunctionCount;
+};
+
+struct SnapshotProperty
+{
+    uint32_t Name;
+    int32_t Offset;
+    int32_t Size;
+};
+
+/**
+ * @brief Functions are heap objects, so only where to find them is stored: the UObjectArray index they had and their
+ *        name to verify the object found there.
+ */
+struct SnapshotFunction
+{
+    uint32_t Name;
+    int32_t ObjectIndex;
+};
+
+/**
+ * @brief Collects reflection data and writes it as a snapshot.
+ */
+class ReflectionSnapshotWriter final
+{
+public:
+    void AddProperty(std::string_view outer, std::string_view name, int32_t offset, int32_t size);
+    void AddFunction(std::string_view outer, std::string_view name, int32_t object_index);
+
+    /**
+     * @brief Write the snapshot to a temporary file and move it over path, so a reader never sees half a file.
+     */
+    bool Save(const std::filesystem::path& path, const ModuleIdentity& module) const;
+
+private:
+    struct PendingClass
+    {
+        /** Names are StringPool ids until saved **/
+        std::vector<SnapshotProperty> Properties{};
+        std::vector<SnapshotFunction> Functions{};
+    };
+
+    StringPool m_Strings{};
+    std::unordered_map<uint32_t, PendingClass> m_Classes{};
+};
+
+/**
+ * @brief A snapshot of reflection data for one build of a module, read in place from a memory mapping.
+ */
+class ReflectionSnapshot final
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @return The snapshot, or an empty optional if the file is missing, malformed, of another version or was written
+     *         for a different build of the module.
+     */
+    static std::optional<ReflectionSnapshot> Open(const std::filesystem::path& path, const ModuleIdentity& module);
+
+    /**
+     * @return The class with a name, or nullptr.
+     */
+    const SnapshotClass* FindClass(std::string_view name) const;
+
+    std::span<const SnapshotClass> Classes() const
+    {
+        return m_Classes;
+    }
+
+    /**
+     * @return The properties of a class, empty if its range is out of bounds.
+     */
+    std::span<const SnapshotProperty> Properties(const SnapshotClass& klass) const;
+
+    /**
+     * @return The functions of a class, empty if its range is out of bounds.
+     */
+    std::span<const SnapshotFunction> Functions(const SnapshotClass& klass) const;
+
+    /**
+     * @return A null-terminated string from the string block, empty if the offset is out of bounds.
+     */
+    std::string_view String(uint32_t offset) const;
+
+    size_t Size() const
+    {
+        return m_File.Size();
+    }
+
+private:
+    explicit ReflectionSnapshot(MappedFile file)
+        : m_File(std::move(file))
+    {
+    }
+
+    MappedFile m_File;
+    std::span<const SnapshotClass> m_Classes{};
+    std::span<const SnapshotProperty> m_Properties{};
+    std::span<const SnapshotFunction> m_Functions{};
+    std::string_view m_Strings{};
+};
@@ -1,72 +1,619 @@
 #include <uescript.h>
 #include "signature.h"
+#include "pattern.h"
+#include "signature_cache.h"
+#include "pe_image.h"
+#include "image_scanner.h"
+#include "xref_scanner.h"
+#include "function_index.h"
+#include "gram_index.h"
+#include "module_cache.h"
+#include "suffix_index.h"
+#include "signature_generator.h"
 
-#define INRANGE(x, a, b) (x >= a && x <= b)
+#include <algorithm>
 
-#define GET_BITS(x)                                                 \
-	(INRANGE((x & (~0x20)), 'A', 'F') ? ((x & (~0x20)) - 'A' + 0xa) \
-									  : (INRANGE(x, '0', '9') ? x - '0' : 0))
-#define GET_BYTE(x) (GET_BITS(x[0]) << 4 | GET_BITS(x[1]))
+/**
+ * @brief Parse the headers of a loaded module. Raises a Lua error if the module is not loaded.
+ * @param module Module name, nullptr for the main executable
+ */
+static PEImage GetModuleImage(lua_State* L, const char* module)
+{
+    std::optional<PEImage> image = PEImage::FromLoaded(reinterpret_cast<const uint8_t*>(GetModuleHandleA(module)));
+    if (!image.has_value())
+        luaL_error(L, "module is not loaded: %s", module != nullptr ? module : "<main>");
+
+    return std::move(image.value());
+}
+
+/**
+ * @brief Parse the headers of the loaded module containing an address. Raises a Lua error if there is none.
+ */
+static PEImage GetModuleImageAt(lua_State* L, const uint8_t* address)
+{
+    HMODULE module = nullptr;
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            reinterpret_cast<LPCSTR>(address), &module))
+    {
+        luaL_error(L, "address %p is not inside a module", address);
+    }
+
+    std::optional<PEImage> image = PEImage::FromLoaded(reinterpret_cast<const uint8_t*>(module));
+    if (!image.has_value())
+        luaL_error(L, "module at %p is not a PE32+ image", module);
 
-std::pair<uintptr_t, uintptr_t> GetModuleSizeAddr(const char* module)
+    return std::move(image.value());
+}
+
+static ModuleCache<FunctionIndex> s_FunctionIndexes{};
+static ModuleCache<SuffixIndex> s_SuffixIndexes{};
+static ModuleCache<GramIndex> s_GramIndexes{};
+
+/** Lookups that scanned linearly because an index was still being built **/
+static std::atomic_uint64_t s_GramIndexFallbacks{0};
+
+/**
+ * @return The module's gram index if sig.EnableIndex was called for it and it is ready, otherwise nullptr.
+ */
+static std::shared_ptr<const GramIndex> GetGramIndex(const PEImage& image)
 {
-    const uintptr_t handle = reinterpret_cast<uintptr_t>(GetModuleHandleA(module));
-    UAssert(handle);
+    const std::optional<std::shared_ptr<const GramIndex>>& index = s_GramIndexes.Peek(image);
+    if (!index.has_value())
+        return nullptr;
 
-    const auto doshdr = reinterpret_cast<PIMAGE_DOS_HEADER>(handle);
-    UAssert(doshdr);
+    if (index.value() == nullptr)
+        ++s_GramIndexFallbacks;
 
-    const auto nt = reinterpret_cast<PIMAGE_NT_HEADERS>(handle + doshdr->e_lfanew);
-    UAssert(nt);
+    return index.value();
+}
 
-    uintptr_t address = handle + nt->OptionalHeader.BaseOfCode;
-    uintptr_t size = address + nt->OptionalHeader.SizeOfCode;
+static ModuleIdentity GetModuleIdentity(const PEImage& image)
+{
+    std::array<char, MAX_PATH> path{};
+    const auto handle = reinterpret_cast<HMODULE>(const_cast<uint8_t*>(image.Base()));
+    const DWORD length = GetModuleFileNameA(handle, path.data(), static_cast<DWORD>(path.size()));
+    UAssert(length != 0);
 
-    return {address, size};
+    return ModuleIdentity::FromImage(stdfs::path(path.data()).filename().string(), image);
+}
+
+/**
+ * @brief Scan memory that may not be readable.
+ * @return false if the scan faulted
+ */
+static bool FindSafe(const uint8_t* begin, const uint8_t* end, const Pattern& pattern, const uint8_t*& match)
+{
+#ifdef SCRIPT_SAFETY_ON
+    __try
+    {
+#endif
+        match = PatternScanner::Find(begin, end, pattern);
+        return true;
+#ifdef SCRIPT_SAFETY_ON
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER)
+    {
+        return false;
+    }
+#endif
+}
+
+/**
+ * @return Whether every page in [begin, end) is committed and readable. Ranges passed by scripts are not tied to a
+ *         module image, so this stands in for clamping to one.
+ */
+static bool IsReadableRange(const uint8_t* begin, const uint8_t* end)
+{
+    constexpr DWORD READABLE = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READ |
+        PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+    for (const uint8_t* cur = begin; cur < end;)
+    {
+        MEMORY_BASIC_INFORMATION info{};
+        if (VirtualQuery(cur, &info, sizeof(info)) == 0)
+            return false;
+
+        if (info.State != MEM_COMMIT || (info.Protect & READABLE) == 0 || (info.Protect & PAGE_GUARD) != 0)
+            return false;
+
+        cur = static_cast<const uint8_t*>(info.BaseAddress) + info.RegionSize;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compile a signature, raising a Lua error if it is malformed.
+ */
+static Pattern CheckPattern(lua_State* L, const int index)
+{
+    const char* signature = luaL_checkstring(L, index);
+    std::optional<Pattern> pattern = Pattern::Compile(signature);
+    if (!pattern.has_value())
+        luaL_error(L, "malformed signature: %s", signature);
+
+    return std::move(pattern.value());
+}
+
+static void PushMatch(lua_State* L, const uint8_t* match)
+{
+    match != nullptr ? lua_pushinteger(L, reinterpret_cast<lua_Integer>(match)) : lua_pushnil(L);
 }
 
 int Signature::Find(lua_State* L)
+{
+    int top = lua_gettop(L);
+
+    // Optional trailing parameter
+    bool parallel = false;
+    if (top >= 1 && lua_isboolean(L, top))
+    {
+        parallel = lua_toboolean(L, top);
+        lua_settop(L, --top);
+    }
+
+    const char* module = nullptr;
+    // Optional parameter
+    if (top >= 2 && lua_isstring(L, -2))
+        module = lua_tostring(L, -2);
+
+    const Pattern& pattern = CheckPattern(L, -1);
+
+    const PEImage& image = GetModuleImage(L, module);
+    const std::shared_ptr<const GramIndex>& index = GetGramIndex(image);
+
+    ImageScanner scanner(image, GetModuleIdentity(image), g_SignatureCache.get());
+    scanner.SetIndex(index.get());
+
+    PushMatch(L, scanner.Find(pattern, parallel));
+    return 1;
+}
+
+int Signature::FindMany(lua_State* L)
 {
     const char* module = nullptr;
     // Optional parameter
     if (lua_gettop(L) >= 2 && lua_isstring(L, -2))
         module = lua_tostring(L, -2);
 
-    const auto [address, size] = GetModuleSizeAddr(module);
+    luaL_checktype(L, -1, LUA_TTABLE);
+    const int input = lua_gettop(L);
 
-    const char* pattern = luaL_checkstring(L, -1);
-    const char* pat = pattern;
+    std::vector<Pattern> patterns;
+    lua_pushnil(L);
+    while (lua_next(L, input) != 0)
+    {
+        patterns.push_back(CheckPattern(L, -1));
+        lua_pop(L, 1);
+    }
+
+    const PEImage& image = GetModuleImage(L, module);
+    const std::shared_ptr<const GramIndex>& index = GetGramIndex(image);
 
-    uintptr_t first_match = 0;
+    ImageScanner scanner(image, GetModuleIdentity(image), g_SignatureCache.get());
+    scanner.SetIndex(index.get());
+    const std::vector<const uint8_t*>& matches = scanner.FindMany(patterns);
 
-    for (uintptr_t cur = address; cur < size; cur++)
+    // Traversal order is stable for an unmodified table, so walk it again to pair keys with results.
+    lua_createtable(L, 0, static_cast<int>(matches.size()));
+    size_t i = 0;
+    lua_pushnil(L);
+    while (lua_next(L, input) != 0)
     {
-        if (!*pat)
+        lua_pop(L, 1);
+        if (const uint8_t* match = matches[i++]; match != nullptr)
         {
-            lua_pushinteger(L, static_cast<lua_Integer>(first_match));
-            return 1;
+            lua_pushvalue(L, -1);
+            lua_pushinteger(L, reinterpret_cast<lua_Integer>(match));
+            lua_settable(L, -4);
         }
+    }
 
-        if (*(uint8_t*)pat == '\?' || *(uint8_t*)cur == GET_BYTE(pat))
+    return 1;
+}
+
+int Signature::FindAll(lua_State* L)
+{
+    const Pattern& pattern = CheckPattern(L, 1);
+    const char* module = luaL_optstring(L, 2, nullptr);
+    const lua_Integer limit = luaL_optinteger(L, 3, 0);
+    const bool parallel = lua_toboolean(L, 4);
+
+    if (limit < 0)
+        return luaL_argerror(L, 3, "limit must not be negative");
+
+    const PEImage& image = GetModuleImage(L, module);
+    const auto [begin, end] = image.CodeRange();
+
+    if (parallel)
+    {
+        const std::vector<const uint8_t*>& matches = PatternScanner::FindAllParallel(
+            begin, end, pattern, static_cast<size_t>(limit));
+
+        lua_createtable(L, static_cast<int>(matches.size()), 0);
+        for (size_t i = 0; i < matches.size(); i++)
         {
-            if (!first_match)
-                first_match = cur;
-
-            if (!pat[2])
-            {
-                lua_pushinteger(L, static_cast<lua_Integer>(first_match));
-                return 1;
-            }
-
-            if (*(uint16_t*)pat == '\?\?' || *(uint8_t*)pat != '\?')
-                pat += 3;
-            else
-                pat += 2;
+            lua_pushinteger(L, reinterpret_cast<lua_Integer>(matches[i]));
+            lua_rawseti(L, -2, static_cast<int>(i + 1));
         }
-        else
+        return 1;
+    }
+
+    // Each search resumes right after the previous match. The table is sized from what was found, the limit is
+    // whatever the script passed.
+    std::vector<const uint8_t*> matches;
+    for (const uint8_t* cur = begin; limit == 0 || static_cast<lua_Integer>(matches.size()) < limit;)
+    {
+        const uint8_t* match = PatternScanner::Find(cur, end, pattern);
+        if (match == nullptr)
+            break;
+
+        matches.push_back(match);
+        cur = match + 1;
+    }
+
+    lua_createtable(L, static_cast<int>(matches.size()), 0);
+    for (size_t i = 0; i < matches.size(); i++)
+    {
+        lua_pushinteger(L, reinterpret_cast<lua_Integer>(matches[i]));
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
+
+    return 1;
+}
+
+/**
+ * @brief State of a sig.Iter userdata.
+ */
+struct SignatureIterator
+{
+    Pattern Compiled;
+    const uint8_t* Cursor;
+    const uint8_t* End;
+};
+
+static constexpr const char* SIGNATURE_ITERATOR_META = "uescript.SignatureIterator";
+
+int Signature::Iter(lua_State* L)
+{
+    Pattern pattern = CheckPattern(L, 1);
+    const char* module = luaL_optstring(L, 2, nullptr);
+
+    const PEImage& image = GetModuleImage(L, module);
+    const auto [begin, end] = image.CodeRange();
+
+    void* memory = lua_newuserdata(L, sizeof(SignatureIterator));
+    new(memory) SignatureIterator{std::move(pattern), begin, end};
+
+    if (luaL_newmetatable(L, SIGNATURE_ITERATOR_META))
+    {
+        lua_pushcfunction(L, IterNext);
+        lua_setfield(L, -2, "__call");
+
+        lua_newtable(L);
         {
-            pat = pattern;
-            first_match = 0;
+            lua_pushcfunction(L, IterNext);
+            lua_setfield(L, -2, "Next");
+        }
+        lua_setfield(L, -2, "__index");
+
+        lua_pushcfunction(L, [](lua_State* L)
+        {
+            static_cast<SignatureIterator*>(luaL_checkudata(L, 1, SIGNATURE_ITERATOR_META))->~SignatureIterator();
+            return 0;
+        });
+        lua_setfield(L, -2, "__gc");
+    }
+    lua_setmetatable(L, -2);
+
+    return 1;
+}
+
+int Signature::IterNext(lua_State* L)
+{
+    const auto iterator = static_cast<SignatureIterator*>(luaL_checkudata(L, 1, SIGNATURE_ITERATOR_META));
+
+    const uint8_t* match = PatternScanner::Find(iterator->Cursor, iterator->End, iterator->Compiled);
+    if (match == nullptr)
+    {
+        // Exhausted, stay that way.
+        iterator->Cursor = iterator->End;
+        lua_pushnil(L);
+        return 1;
+    }
+
+    iterator->Cursor = match + 1;
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(match));
+    return 1;
+}
+
+int Signature::FindInRange(lua_State* L)
+{
+    const auto begin = reinterpret_cast<const uint8_t*>(luaL_checkinteger(L, 1));
+    const lua_Integer length = luaL_checkinteger(L, 2);
+    const Pattern& pattern = CheckPattern(L, 3);
+
+    if (begin == nullptr)
+        return luaL_argerror(L, 1, "null pointer");
+    if (length <= 0)
+        return luaL_argerror(L, 2, "length must be positive");
+    if (static_cast<uint64_t>(length) > UINTPTR_MAX - reinterpret_cast<uintptr_t>(begin))
+        return luaL_argerror(L, 2, "range wraps around the address space");
+    if (!IsReadableRange(begin, begin + length))
+        return luaL_error(L, "%p-%p is not readable memory", begin, begin + length);
+
+    const uint8_t* match = nullptr;
+    if (!FindSafe(begin, begin + length, pattern, match))
+        return luaL_error(L, "access violation scanning %p-%p", begin, begin + length);
+
+    PushMatch(L, match);
+    return 1;
+}
+
+int Signature::FindInSection(lua_State* L)
+{
+    const char* module = luaL_optstring(L, 1, nullptr);
+    const char* section_name = luaL_checkstring(L, 2);
+    const Pattern& pattern = CheckPattern(L, 3);
+
+    const PEImage& image = GetModuleImage(L, module);
+    const PEImage::Section* section = image.FindSection(section_name);
+    if (section == nullptr)
+        return luaL_error(L, "no section named %s", section_name);
+
+    const auto [begin, end] = image.SectionRange(*section);
+    PushMatch(L, PatternScanner::Find(begin, end, pattern));
+    return 1;
+}
+
+int Signature::FindInBuffer(lua_State* L)
+{
+    size_t length = 0;
+    const auto buffer = reinterpret_cast<const uint8_t*>(luaL_checklstring(L, 1, &length));
+    const Pattern& pattern = CheckPattern(L, 2);
+    const lua_Integer init = luaL_optinteger(L, 3, 1);
+
+    if (init < 1)
+        return luaL_argerror(L, 3, "init must be at least 1");
+
+    if (static_cast<size_t>(init - 1) >= length)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    // The string is scanned in place, no copy is made.
+    const uint8_t* match = PatternScanner::Find(buffer + init - 1, buffer + length, pattern);
+    if (match == nullptr)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushinteger(L, static_cast<lua_Integer>(match - buffer + 1));
+    return 1;
+}
+
+int Signature::FindXrefs(lua_State* L)
+{
+    const auto target = reinterpret_cast<const uint8_t*>(luaL_checkinteger(L, 1));
+    const char* module = luaL_optstring(L, 2, nullptr);
+    const lua_Integer limit = luaL_optinteger(L, 3, 0);
+
+    if (limit < 0)
+        return luaL_argerror(L, 3, "limit must not be negative");
+
+    const PEImage& image = GetModuleImage(L, module);
+    const auto [begin, end] = image.CodeRange();
+
+    const std::vector<Xref>& xrefs = XrefScanner::Find(begin, end, target, static_cast<size_t>(limit));
+
+    lua_createtable(L, static_cast<int>(xrefs.size()), 0);
+    for (size_t i = 0; i < xrefs.size(); i++)
+    {
+        lua_pushinteger(L, reinterpret_cast<lua_Integer>(xrefs[i].Instruction));
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
+
+    return 1;
+}
+
+int Signature::FindXrefsMany(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    const char* module = luaL_optstring(L, 2, nullptr);
+
+    std::vector<const uint8_t*> targets;
+    targets.reserve(lua_objlen(L, 1));
+
+    lua_pushnil(L);
+    while (lua_next(L, 1) != 0)
+    {
+        if (!lua_isnumber(L, -1))
+            return luaL_argerror(L, 1, "targets must be an array of addresses");
+
+        targets.push_back(reinterpret_cast<const uint8_t*>(lua_tointeger(L, -1)));
+        lua_pop(L, 1);
+    }
+
+    const PEImage& image = GetModuleImage(L, module);
+    const auto [begin, end] = image.CodeRange();
+
+    // Results are in address order, group them by target.
+    std::unordered_map<const uint8_t*, std::vector<const uint8_t*>> grouped;
+    for (const Xref& xref : XrefScanner::FindMany(begin, end, targets))
+        grouped[xref.Target].push_back(xref.Instruction);
+
+    lua_createtable(L, 0, static_cast<int>(grouped.size()));
+    for (const auto& [target, instructions] : grouped)
+    {
+        lua_pushinteger(L, reinterpret_cast<lua_Integer>(target));
+        lua_createtable(L, static_cast<int>(instructions.size()), 0);
+        for (size_t i = 0; i < instructions.size(); i++)
+        {
+            lua_pushinteger(L, reinterpret_cast<lua_Integer>(instructions[i]));
+            lua_rawseti(L, -2, static_cast<int>(i + 1));
+        }
+        lua_settable(L, -3);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Append every occurrence of a byte string in [begin, end) to out.
+ * @param alignment Only keep occurrences aligned to this, e.g. 2 for UTF-16
+ */
+static void FindLiterals(const uint8_t* begin, const uint8_t* end, const std::string_view bytes, const size_t alignment,
+                         std::vector<const uint8_t*>& out)
+{
+    const Pattern& pattern = Pattern::FromBytes(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    for (const uint8_t* cur = begin;;)
+    {
+        const uint8_t* match = PatternScanner::Find(cur, end, pattern);
+        if (match == nullptr)
+            break;
+
+        if (reinterpret_cast<uintptr_t>(match) % alignment == 0)
+            out.push_back(match);
+        cur = match + 1;
+    }
+}
+
+int Signature::FindByString(lua_State* L)
+{
+    size_t length = 0;
+    const char* string = luaL_checklstring(L, 1, &length);
+    const char* module = luaL_optstring(L, 2, nullptr);
+    const std::string_view encoding = luaL_optstring(L, 3, "both");
+
+    const bool ascii = encoding == "ascii" || encoding == "both";
+    const bool utf16 = encoding == "utf16" || encoding == "both";
+    if (!ascii && !utf16)
+        return luaL_argerror(L, 3, "encoding must be \"ascii\", \"utf16\" or \"both\"");
+    if (length == 0)
+        return luaL_argerror(L, 1, "string must not be empty");
+
+    const PEImage& image = GetModuleImage(L, module);
+    const PEImage::Section* rdata = image.FindSection(".rdata");
+    if (rdata == nullptr)
+        return luaL_error(L, "module has no .rdata section");
+
+    const auto [rdata_begin, rdata_end] = image.SectionRange(*rdata);
+
+    // Include the terminator so only whole literals (or the tail of a merged one) match.
+    std::vector<const uint8_t*> literals;
+    if (ascii)
+        FindLiterals(rdata_begin, rdata_end, std::string_view(string, length + 1), 1, literals);
+    if (utf16)
+    {
+        // The converted string includes its terminator.
+        const std::wstring& wide = StringUtl::AsciiToWideString(string);
+        const std::string_view bytes(reinterpret_cast<const char*>(wide.data()), wide.size() * sizeof(wchar_t));
+        FindLiterals(rdata_begin, rdata_end, bytes, sizeof(wchar_t), literals);
+    }
+
+    const auto [begin, end] = image.CodeRange();
+    const std::vector<Xref>& xrefs = XrefScanner::FindMany(begin, end, literals);
+
+    const std::shared_ptr<const FunctionIndex>& index = s_FunctionIndexes.Get(image);
+
+    // Several references in one function are common, report each function once.
+    std::vector<const uint8_t*> functions;
+    for (const Xref& xref : xrefs)
+    {
+        const auto rva = static_cast<uint32_t>(xref.Instruction - image.Base());
+        if (const FunctionIndex::Chunk* chunk = index->FindChunk(rva); chunk != nullptr)
+            functions.push_back(image.Base() + chunk->Function);
+    }
+    std::ranges::sort(functions);
+    functions.erase(std::ranges::unique(functions).begin(), functions.end());
+
+    lua_createtable(L, static_cast<int>(functions.size()), 0);
+    for (size_t i = 0; i < functions.size(); i++)
+    {
+        lua_pushinteger(L, reinterpret_cast<lua_Integer>(functions[i]));
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
+
+    lua_createtable(L, static_cast<int>(xrefs.size()), 0);
+    for (size_t i = 0; i < xrefs.size(); i++)
+    {
+        lua_pushinteger(L, reinterpret_cast<lua_Integer>(xrefs[i].Instruction));
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
+
+    return 2;
+}
+
+/**
+ * @brief The function containing an address, see LookupFunction.
+ */
+struct FunctionLookup
+{
+    PEImage Image;
+    std::shared_ptr<const FunctionIndex> Index;
+    /** Chunk containing the address, nullptr if it is not inside a known function **/
+    const FunctionIndex::Chunk* Chunk;
+};
+
+/**
+ * @brief Find the function containing an address. Raises a Lua error if the address is not inside a module.
+ */
+static FunctionLookup LookupFunction(lua_State* L, const uint8_t* address)
+{
+    PEImage image = GetModuleImageAt(L, address);
+    std::shared_ptr<const FunctionIndex> index = s_FunctionIndexes.Get(image);
+    const FunctionIndex::Chunk* chunk = index->FindChunk(static_cast<uint32_t>(address - image.Base()));
+    return {std::move(image), std::move(index), chunk};
+}
+
+int Signature::FunctionAt(lua_State* L)
+{
+    const auto address = reinterpret_cast<const uint8_t*>(luaL_checkinteger(L, 1));
+
+    const FunctionLookup& lookup = LookupFunction(L, address);
+    PushMatch(L, lookup.Chunk != nullptr ? lookup.Image.Base() + lookup.Chunk->Function : nullptr);
+    return 1;
+}
+
+int Signature::FunctionRange(lua_State* L)
+{
+    const auto address = reinterpret_cast<const uint8_t*>(luaL_checkinteger(L, 1));
+
+    const FunctionLookup& lookup = LookupFunction(L, address);
+    if (lookup.Chunk == nullptr)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    // Report the chunk at the start of the function, even if the address is in one of its other chunks.
+    const std::span<const FunctionIndex::Chunk> chunks = lookup.Index->FunctionChunks(lookup.Chunk->Function);
+    const FunctionIndex::Chunk& primary = chunks.empty() ? *lookup.Chunk : chunks.front();
+
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(lookup.Image.Base() + primary.Begin));
+    lua_pushinteger(L, reinterpret_cast<lua_Integer>(lookup.Image.Base() + primary.End));
+    return 2;
+}
+
+int Signature::FindInFunction(lua_State* L)
+{
+    const auto address = reinterpret_cast<const uint8_t*>(luaL_checkinteger(L, 1));
+    const Pattern& pattern = CheckPattern(L, 2);
+
+    const FunctionLookup& lookup = LookupFunction(L, address);
+    if (lookup.Chunk == nullptr)
+        return luaL_argerror(L, 1, "address is not inside a known function");
+
+    // Scan the start of the function first, then its other chunks in address order.
+    const uint8_t* base = lookup.Image.Base();
+    for (const FunctionIndex::Chunk& chunk : lookup.Index->FunctionChunks(lookup.Chunk->Function))
+    {
+        if (const uint8_t* match = PatternScanner::Find(base + chunk.Begin, base + chunk.End, pattern); match != nullptr)
+        {
+            PushMatch(L, match);
+            return 1;
         }
     }
 
@@ -74,6 +621,86 @@ int Signature::Find(lua_State* L)
     return 1;
 }
 
+int Signature::Generate(lua_State* L)
+{
+    const auto address = reinterpret_cast<const uint8_t*>(luaL_checkinteger(L, 1));
+    const char* module = luaL_optstring(L, 2, nullptr);
+
+    const PEImage& image = module != nullptr ? GetModuleImage(L, module) : GetModuleImageAt(L, address);
+    const auto [begin, end] = image.CodeRange();
+    if (address < begin || address >= end)
+        return luaL_argerror(L, 1, "address is not inside the module's code");
+
+    // The first call for a module builds the index, which takes a moment for large executables.
+    const std::shared_ptr<const SuffixIndex>& index = s_SuffixIndexes.Get(image);
+
+    const std::optional<std::string>& signature = SignatureGenerator::Generate(image, *index, address);
+    if (!signature.has_value())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushlstring(L, signature->data(), signature->size());
+    return 1;
+}
+
+int Signature::EnableIndex(lua_State* L)
+{
+    const char* module = luaL_optstring(L, 1, nullptr);
+
+    s_GramIndexes.Prepare(GetModuleImage(L, module));
+    return 0;
+}
+
+void Signature::Shutdown()
+{
+    s_GramIndexes.Shutdown();
+}
+
+int Signature::IndexStats(lua_State* L)
+{
+    const char* module = luaL_optstring(L, 1, nullptr);
+
+    const std::optional<std::shared_ptr<const GramIndex>>& index = s_GramIndexes.Peek(GetModuleImage(L, module));
+    if (!index.has_value())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, 0, 7);
+
+    lua_pushboolean(L, index.value() != nullptr);
+    lua_setfield(L, -2, "Ready");
+    lua_pushinteger(L, static_cast<lua_Integer>(s_GramIndexFallbacks.load()));
+    lua_setfield(L, -2, "Fallbacks");
+
+    if (const std::shared_ptr<const GramIndex>& ready = index.value(); ready != nullptr)
+    {
+        const uint64_t hits = ready->Hits();
+        const uint64_t misses = ready->Misses();
+        const lua_Number hit_rate = hits + misses != 0
+                                        ? static_cast<lua_Number>(hits) / static_cast<lua_Number>(hits + misses)
+                                        : 0.0;
+
+        lua_pushinteger(L, static_cast<lua_Integer>(ready->MemoryUsage()));
+        lua_setfield(L, -2, "Memory");
+        lua_pushnumber(L, static_cast<lua_Number>(ready->BuildTime().count()) / 1000.0);
+        lua_setfield(L, -2, "BuildTime");
+        lua_pushinteger(L, static_cast<lua_Integer>(hits));
+        lua_setfield(L, -2, "Hits");
+        lua_pushinteger(L, static_cast<lua_Integer>(misses));
+        lua_setfield(L, -2, "Misses");
+        lua_pushinteger(L, static_cast<lua_Integer>(ready->Candidates()));
+        lua_setfield(L, -2, "Candidates");
+        lua_pushnumber(L, hit_rate);
+        lua_setfield(L, -2, "HitRate");
+    }
+
+    return 1;
+}
+
 int Signature::Rip(lua_State* L)
 {
     const uintptr_t address = luaL_checkinteger(L, -3);
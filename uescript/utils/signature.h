@@ -9,11 +9,95 @@ class Signature final
 public:
     Signature() = delete;
     /**
-     * @brief Scans for a signature and pushes the address or nil if it could not be found.
+     * @brief Scans for a signature and pushes the address or nil if it could not be found. Pass true as the last
+     *        argument to split the scan across all hardware threads.
      */
     static int Find(lua_State* L);
+    /**
+     * @brief Scans for a table of signatures in a single pass and pushes a table mapping each key to its address.
+     *        Signatures that could not be found are left out of the result.
+     */
+    static int FindMany(lua_State* L);
+    /**
+     * @brief sig.FindAll(pattern, [module], [limit], [parallel]). Pushes an array of every match in ascending order.
+     */
+    static int FindAll(lua_State* L);
+    /**
+     * @brief sig.Iter(pattern, [module]). Pushes an iterator that returns the next match each time it is called,
+     *        resuming after the previous match. Usable directly in a generic for loop.
+     */
+    static int Iter(lua_State* L);
+    /**
+     * @brief sig.FindInRange(start, length, pattern). Scans arbitrary memory, e.g. heap regions. The whole range must be
+     *        committed and readable.
+     */
+    static int FindInRange(lua_State* L);
+    /**
+     * @brief sig.FindInSection([module], section, pattern). Scans a named section such as ".rdata" or ".data".
+     */
+    static int FindInSection(lua_State* L);
+    /**
+     * @brief sig.FindInBuffer(buffer, pattern, [init]). Scans a Lua string in place and pushes the 1-based index of
+     *        the match, like string.find.
+     */
+    static int FindInBuffer(lua_State* L);
+    /**
+     * @brief sig.FindXrefs(target, [module], [limit]). Pushes an array of every instruction in the module's code that
+     *        references target through a rel32 or RIP-relative operand (lea, mov, call, jmp, cmp, ...).
+     */
+    static int FindXrefs(lua_State* L);
+    /**
+     * @brief sig.FindXrefsMany(targets, [module]). Finds references to an array of addresses in a single pass and
+     *        pushes a table mapping each referenced address to an array of instructions.
+     */
+    static int FindXrefsMany(lua_State* L);
+    /**
+     * @brief sig.FindByString(string, [module], [encoding]). Finds the null-terminated literal in .rdata as ASCII
+     *        and/or UTF-16 ("ascii", "utf16", default both), then the code referencing it. Pushes an array of the
+     *        start of each function containing a reference and an array of the referencing instructions.
+     */
+    static int FindByString(lua_State* L);
+    /**
+     * @brief sig.FunctionAt(address). Pushes the start of the function containing an address, or nil if it is not
+     *        inside a function listed in the module's exception directory.
+     */
+    static int FunctionAt(lua_State* L);
+    /**
+     * @brief sig.FunctionRange(address). Pushes the start and end of the function containing an address, or nil.
+     *        For a function split into chunks, this is the range of the chunk at its start.
+     */
+    static int FunctionRange(lua_State* L);
+    /**
+     * @brief sig.FindInFunction(address, pattern). Scans only the function containing an address, including any
+     *        chunks it was split into.
+     */
+    static int FindInFunction(lua_State* L);
+    /**
+     * @brief sig.Generate(address, [module]). Pushes the shortest signature starting at address that is unique in
+     *        the module's code, with relative and relocated operands wildcarded, or nil if there is none. The first
+     *        call for a module indexes its code.
+     */
+    static int Generate(lua_State* L);
+    /**
+     * @brief sig.EnableIndex([module]). Starts indexing the module's code on a background thread. Once the index is
+     *        ready, sig.Find and sig.FindMany verify a few candidates instead of scanning, and scan as usual until then.
+     */
+    static int EnableIndex(lua_State* L);
+    /**
+     * @brief sig.IndexStats([module]). Pushes a table describing the module's index (Ready, Memory in bytes,
+     *        BuildTime in ms, Hits, Misses, Candidates and HitRate), or nil if it was never enabled. Fallbacks counts
+     *        lookups in any module that scanned because the index was still building.
+     */
+    static int IndexStats(lua_State* L);
     /**
      * @brief Convert a relative pointer to absolute and pushes the result.
      */
     static int Rip(lua_State* L);
+    /**
+     * @brief Stop indexing started by sig.EnableIndex and wait for it to exit. Call before the module is unloaded.
+     */
+    static void Shutdown();
+
+private:
+    static int IterNext(lua_State* L);
 };
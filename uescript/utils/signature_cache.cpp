@@ -0,0 +1,169 @@
+#include "signature_cache.h"
+#include "pe_image.h"
+
+#include <fstream>
+#include <sstream>
+
+static constexpr std::string_view CACHE_HEADER = "# uescript signature cache v1";
+
+/*
+ * File format, one entry per line:
+ *   <module name> <timestamp> <size of image> <text hash> <rva> <pattern...>
+ * Numbers are hexadecimal. Later lines override earlier ones for the same module and pattern.
+*/
+
+ModuleIdentity ModuleIdentity::FromImage(const std::string_view file_name, const PEImage& image)
+{
+    const pe::NtHeaders64& headers = image.Headers();
+
+    ModuleIdentity identity{};
+    identity.Name = NormalizeName(file_name);
+    identity.TimeDateStamp = headers.FileHeader.TimeDateStamp;
+    identity.SizeOfImage = headers.OptionalHeader.SizeOfImage;
+
+    if (const PEImage::Section* text = image.FindSection(".text"); text != nullptr)
+        identity.TextHash = SignatureCache::Hash(text->Header, sizeof(pe::SectionHeader));
+
+    return identity;
+}
+
+SignatureCache::SignatureCache(std::filesystem::path path)
+    : m_Path(std::move(path))
+{
+    Load();
+}
+
+std::optional<uint32_t> SignatureCache::Lookup(const ModuleIdentity& module, const std::string_view pattern)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    const auto& it = m_Entries.find(MakeKey(module, pattern));
+    if (it == m_Entries.end())
+        return {};
+
+    if (!it->second.Module.SameBuild(module))
+    {
+        // The module has been updated since this entry was recorded. Everything recorded for the old build is stale.
+        std::erase_if(m_Entries, [&module](const auto& pair)
+        {
+            const ModuleIdentity& cached = pair.second.Module;
+            return cached.Name == module.Name && !cached.SameBuild(module);
+        });
+        Save();
+        return {};
+    }
+
+    return it->second.Rva;
+}
+
+void SignatureCache::Insert(const ModuleIdentity& module, const std::string_view pattern, const uint32_t rva)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    const std::string& key = MakeKey(module, pattern);
+    const Entry entry{module, rva};
+    m_Entries.insert_or_assign(key, entry);
+    Append(key, entry);
+}
+
+void SignatureCache::Remove(const ModuleIdentity& module, const std::string_view pattern)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    if (m_Entries.erase(MakeKey(module, pattern)) != 0)
+        Save();
+}
+
+uint64_t SignatureCache::Hash(const void* data, const size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    const auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+std::string SignatureCache::MakeKey(const ModuleIdentity& module, const std::string_view pattern)
+{
+    std::string key;
+    key.reserve(module.Name.size() + 1 + pattern.size());
+    key += module.Name;
+    key += ' ';
+    key += pattern;
+    return key;
+}
+
+void SignatureCache::Load()
+{
+    std::ifstream in(m_Path);
+    if (!in)
+        return;
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        Entry entry{};
+        stream >> entry.Module.Name >> std::hex >> entry.Module.TimeDateStamp >> entry.Module.SizeOfImage >> entry.
+            Module.TextHash >> entry.Rva;
+
+        std::string pattern;
+        std::getline(stream >> std::ws, pattern);
+
+        // Ignore anything malformed, it will be rescanned and rewritten.
+        if (stream.fail() || pattern.empty())
+            continue;
+
+        m_Entries.insert_or_assign(MakeKey(entry.Module, pattern), entry);
+    }
+}
+
+/**
+ * @brief Write one entry as a line of the cache file.
+ */
+static void WriteEntry(std::ostream& out, const std::string& key, const ModuleIdentity& module, const uint32_t rva)
+{
+    // The key already starts with the module name.
+    const std::string_view pattern = std::string_view(key).substr(module.Name.size() + 1);
+    out << module.Name << std::hex << ' ' << module.TimeDateStamp << ' ' << module.SizeOfImage << ' ' <<
+        module.TextHash << ' ' << rva << ' ' << pattern << '\n';
+}
+
+void SignatureCache::Save() const
+{
+    // Written next to the cache and renamed over it, so a crash part-way through leaves the old file intact.
+    std::filesystem::path temp_path = m_Path;
+    temp_path += ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::trunc);
+        if (!out)
+            return;
+
+        out << CACHE_HEADER << '\n';
+        for (const auto& [key, entry] : m_Entries)
+            WriteEntry(out, key, entry.Module, entry.Rva);
+
+        if (!out)
+            return;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, m_Path, error);
+}
+
+void SignatureCache::Append(const std::string& key, const Entry& entry) const
+{
+    const bool exists = std::filesystem::exists(m_Path);
+
+    std::ofstream out(m_Path, std::ios::app);
+    if (!exists)
+        out << CACHE_HEADER << '\n';
+
+    WriteEntry(out, key, entry.Module, entry.Rva);
+}
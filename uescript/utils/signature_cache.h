@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class PEImage;
+
+/*
+ * Like pattern.h, this does not depend on Windows or Lua so offline tools can read and write the same cache file.
+*/
+
+/**
+ * @brief Identifies a specific build of a module. Any rebuild changes at least one of these.
+ */
+struct ModuleIdentity
+{
+    /** Lowercase file name of the module, e.g. "examplegame-win64-shipping.exe" **/
+    std::string Name;
+    uint32_t TimeDateStamp{0};
+    uint32_t SizeOfImage{0};
+    /** Hash of the .text section header **/
+    uint64_t TextHash{0};
+
+    /**
+     * @brief Lowercase a module file name and replace whitespace so it can be stored as a single token.
+     */
+    static std::string NormalizeName(std::string_view name)
+    {
+        std::string result(name);
+        for (char& c : result)
+        {
+            if (c == ' ' || c == '\t')
+                c = '_';
+            else if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+        }
+        return result;
+    }
+
+    /**
+     * @brief Identify a module from its headers. Gives the same result for the file on disk and the loaded module.
+     * @param file_name File name of the module, without any directories
+     */
+    static ModuleIdentity FromImage(std::string_view file_name, const PEImage& image);
+
+    bool SameBuild(const ModuleIdentity& other) const
+    {
+        return TimeDateStamp == other.TimeDateStamp && SizeOfImage == other.SizeOfImage && TextHash == other.TextHash;
+    }
+};
+
+/**
+ * @brief Persistent cache of signature scan results. Maps a module and a pattern to the RVA it was found at.
+ *        Entries recorded for a different build of the module are dropped when they are looked up.
+ */
+class SignatureCache final
+{
+public:
+    explicit SignatureCache(std::filesystem::path path);
+
+    // No copy constructors.
+    SignatureCache& operator=(const SignatureCache&) = delete;
+    SignatureCache(const SignatureCache&) = delete;
+
+    /**
+     * @brief Look up the RVA of a pattern.
+     * @param pattern Pattern in canonical form (Pattern::ToString)
+     * @return The cached RVA, or an empty optional if there is no entry for this build of the module
+     */
+    std::optional<uint32_t> Lookup(const ModuleIdentity& module, std::string_view pattern);
+
+    /**
+     * @brief Record the RVA of a pattern. The entry is appended to the cache file immediately.
+     */
+    void Insert(const ModuleIdentity& module, std::string_view pattern, uint32_t rva);
+
+    /**
+     * @brief Drop an entry, e.g. after the bytes at its RVA no longer match the pattern.
+     */
+    void Remove(const ModuleIdentity& module, std::string_view pattern);
+
+    /**
+     * @brief 64-bit FNV-1a.
+     */
+    static uint64_t Hash(const void* data, size_t size);
+
+private:
+    struct Entry
+    {
+        ModuleIdentity Module;
+        uint32_t Rva;
+    };
+
+    static std::string MakeKey(const ModuleIdentity& module, std::string_view pattern);
+
+    void Load();
+    /**
+     * @brief Rewrite the whole file from memory through a temporary file. The file is otherwise append-only, this
+     *        compacts it.
+     */
+    void Save() const;
+    void Append(const std::string& key, const Entry& entry) const;
+
+    std::filesystem::path m_Path;
+    std::mutex m_Mutex{};
+    std::unordered_map<std::string, Entry> m_Entries{};
+};
+
+inline std::unique_ptr<SignatureCache> g_SignatureCache{nullptr};
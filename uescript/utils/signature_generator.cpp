@@ -0,0 +1,96 @@
+#include "signature_generator.h"
+#include "pe_image.h"
+#include "suffix_index.h"
+#include "xref_scanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::vector<uint8_t> SignatureGenerator::VolatileMask(const PEImage& image, const uint8_t* address, const size_t size)
+{
+    std::vector<uint8_t> mask(size, 0xFF);
+
+    const uint8_t* base = image.Base();
+    const auto image_begin = reinterpret_cast<uintptr_t>(base);
+    const uintptr_t image_end = image_begin + image.Headers().OptionalHeader.SizeOfImage;
+
+    // Absolute addresses, e.g. mov rax, imm64. A relocation starting up to 7 bytes before address still covers the
+    // first bytes.
+    constexpr uint32_t RELOCATION_SIZE = 8;
+    const auto rva = static_cast<uint32_t>(address - base);
+    const uint32_t first = rva >= RELOCATION_SIZE - 1 ? rva - (RELOCATION_SIZE - 1) : 0;
+    for (const uint32_t relocation : image.Relocations(first, rva + static_cast<uint32_t>(size)))
+    {
+        const size_t begin = relocation > rva ? relocation - rva : 0;
+        const size_t end = std::min<size_t>(size, relocation + RELOCATION_SIZE - rva);
+        if (begin < end)
+            std::fill(mask.begin() + begin, mask.begin() + end, 0x00);
+    }
+
+    // Relative operands that point into the image. Anything else that happens to decode as one is wildcarded too,
+    // which only costs a little specificity.
+    for (size_t offset = 1; offset + 4 <= size;)
+    {
+        int32_t disp;
+        std::memcpy(&disp, address + offset, sizeof(disp));
+        const uintptr_t next = reinterpret_cast<uintptr_t>(address + offset + 4) + static_cast<intptr_t>(disp);
+
+        bool relative = false;
+        for (const size_t immediate : {0, 1, 4})
+        {
+            const uintptr_t target = next + immediate;
+            if (target >= image_begin && target < image_end &&
+                XrefScanner::DecodeReference(address, address + offset, immediate) != nullptr)
+            {
+                relative = true;
+                break;
+            }
+        }
+
+        if (!relative)
+        {
+            offset++;
+            continue;
+        }
+
+        std::fill_n(mask.begin() + offset, 4, 0x00);
+        offset += 4;
+    }
+
+    return mask;
+}
+
+std::optional<std::string> SignatureGenerator::Generate(const PEImage& image, const SuffixIndex& index,
+                                                        const uint8_t* address)
+{
+    if (address < index.Begin() || address >= index.End())
+        return {};
+
+    const size_t size = std::min(MAX_LENGTH, static_cast<size_t>(index.End() - address));
+    const std::vector<uint8_t>& mask = VolatileMask(image, address, size);
+
+    const std::optional<size_t> length = index.ShortestUnique(address, mask.data(), size);
+    if (!length.has_value())
+        return {};
+
+    // The last byte is always concrete, a wildcard can't make a pattern unique.
+    constexpr char digits[] = "0123456789ABCDEF";
+
+    std::string signature;
+    signature.reserve(length.value() * 3);
+    for (size_t i = 0; i < length.value(); i++)
+    {
+        if (i != 0)
+            signature += ' ';
+
+        if (mask[i] == 0x00)
+        {
+            signature += '?';
+            continue;
+        }
+
+        signature += digits[address[i] >> 4];
+        signature += digits[address[i] & 0x0F];
+    }
+    return signature;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class PEImage;
+class SuffixIndex;
+
+/**
+ * @brief Generates signatures for code, e.g. to replace one broken by a game update.
+ */
+class SignatureGenerator final
+{
+public:
+    SignatureGenerator() = delete;
+
+    /**
+     * @brief Bytes after the start address that are considered. A signature longer than this is not worth having.
+     */
+    static constexpr size_t MAX_LENGTH = 128;
+
+    /**
+     * @brief Generate the shortest signature starting at an address that is unique within the indexed code.
+     * @param index Index over the image's code range
+     * @return The signature in canonical IDA-style form, or an empty optional if there is no unique one
+     */
+    static std::optional<std::string> Generate(const PEImage& image, const SuffixIndex& index, const uint8_t* address);
+
+    /**
+     * @brief Work out which bytes of [address, address + size) change when the module is rebuilt or rebased:
+     *        rel32/disp32 operands referencing the image and 64-bit addresses listed in the relocation directory.
+     * @return 0xFF for bytes to keep, 0x00 for bytes to wildcard
+     */
+    static std::vector<uint8_t> VolatileMask(const PEImage& image, const uint8_t* address, size_t size);
+};
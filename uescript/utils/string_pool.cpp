@@ -0,0 +1,54 @@
+#include "string_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint32_t StringPool::Intern(const std::string_view string)
+{
+    if (const auto it = m_Ids.find(string); it != m_Ids.end())
+        return it->second;
+
+    // Strings never straddle blocks, a string larger than a block gets one of its own.
+    const size_t required = string.size() + 1;
+    if (m_BlockUsed + required > BLOCK_SIZE || m_Blocks.empty())
+    {
+        const size_t size = std::max(BLOCK_SIZE, required);
+        m_Blocks.push_back(std::make_unique<char[]>(size));
+        m_BlockUsed = 0;
+        m_BlockBytes += size;
+    }
+
+    char* data = m_Blocks.back().get() + m_BlockUsed;
+    std::memcpy(data, string.data(), string.size());
+    data[string.size()] = '\0';
+    m_BlockUsed += required;
+
+    const auto id = static_cast<uint32_t>(m_Strings.size());
+    const std::string_view& stored = m_Strings.emplace_back(data, string.size());
+    m_Ids.emplace(stored, id);
+    return id;
+}
+
+std::optional<uint32_t> StringPool::Find(const std::string_view string) const
+{
+    if (const auto it = m_Ids.find(string); it != m_Ids.end())
+        return it->second;
+
+    return {};
+}
+
+size_t StringPool::MemoryUsage() const
+{
+    // Each hash node holds the view, the id and a next pointer, plus a bucket pointer.
+    constexpr size_t node_size = sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*);
+    return m_BlockBytes + m_Strings.capacity() * sizeof(std::string_view) + m_Ids.size() * node_size;
+}
+
+void StringPool::Clear()
+{
+    m_Blocks.clear();
+    m_BlockUsed = BLOCK_SIZE;
+    m_BlockBytes = 0;
+    m_Strings.clear();
+    m_Ids.clear();
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Like pattern.h, this does not depend on Windows or Lua.
+*/
+
+/**
+ * @brief Interns strings and hands out dense ids for them. Strings are stored back to back in large blocks and are
+ *        null-terminated, so views returned by Get stay valid and can be passed on as C strings.
+ */
+class StringPool final
+{
+public:
+    StringPool() = default;
+
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(const StringPool&) = delete;
+
+    /**
+     * @return The id of a string, adding it if it is new.
+     */
+    uint32_t Intern(std::string_view string);
+
+    /**
+     * @return The id of a string, or an empty optional if it was never interned.
+     */
+    std::optional<uint32_t> Find(std::string_view string) const;
+
+    /**
+     * @return The string with an id, null-terminated.
+     */
+    std::string_view Get(const uint32_t id) const
+    {
+        return m_Strings[id];
+    }
+
+    size_t Size() const
+    {
+        return m_Strings.size();
+    }
+
+    /**
+     * @return Approximate bytes allocated, including the lookup table.
+     */
+    size_t MemoryUsage() const;
+
+    void Clear();
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> m_Blocks{};
+    /** Bytes used in the last block **/
+    size_t m_BlockUsed{BLOCK_SIZE};
+    size_t m_BlockBytes{0};
+    std::vector<std::string_view> m_Strings{};
+    std::unordered_map<std::string_view, uint32_t> m_Ids{};
+};
@@ -0,0 +1,128 @@
+#include "suffix_index.h"
+#include "pe_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <tuple>
+
+/**
+ * @brief Suffixes are first distributed into buckets by their first two bytes, each bucket is then sorted on its own.
+ */
+static constexpr size_t BUCKET_COUNT = 1 << 16;
+
+SuffixIndex::SuffixIndex(const PEImage& image)
+{
+    std::tie(m_Begin, m_End) = image.CodeRange();
+
+    const size_t size = static_cast<size_t>(m_End - m_Begin);
+    if (size == 0)
+        return;
+
+    const auto bucket_of = [this, size](const size_t offset)
+    {
+        const uint8_t second = offset + 1 < size ? m_Begin[offset + 1] : 0;
+        return static_cast<size_t>(m_Begin[offset]) << 8 | second;
+    };
+
+    // Counting sort into buckets.
+    std::vector<uint32_t> bucket_starts(BUCKET_COUNT + 1, 0);
+    for (size_t offset = 0; offset < size; offset++)
+    {
+        if (IsIndexed(m_Begin[offset]))
+            bucket_starts[bucket_of(offset) + 1]++;
+    }
+
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+        bucket_starts[bucket + 1] += bucket_starts[bucket];
+
+    m_Suffixes.resize(bucket_starts[BUCKET_COUNT]);
+    {
+        std::vector<uint32_t> cursors(bucket_starts.begin(), bucket_starts.end() - 1);
+        for (size_t offset = 0; offset < size; offset++)
+        {
+            if (IsIndexed(m_Begin[offset]))
+                m_Suffixes[cursors[bucket_of(offset)]++] = static_cast<uint32_t>(offset);
+        }
+    }
+
+    // Order within a bucket by the first DEPTH bytes. A suffix that ends early sorts before its extensions.
+    const auto less = [this, size](const uint32_t a, const uint32_t b)
+    {
+        const size_t length_a = std::min(DEPTH, size - a);
+        const size_t length_b = std::min(DEPTH, size - b);
+        const int result = std::memcmp(m_Begin + a, m_Begin + b, std::min(length_a, length_b));
+        return result != 0 ? result < 0 : length_a < length_b;
+    };
+
+    std::atomic_size_t next_bucket{0};
+    const auto worker = [&]
+    {
+        for (size_t bucket = next_bucket++; bucket < BUCKET_COUNT; bucket = next_bucket++)
+        {
+            const auto first = m_Suffixes.begin() + bucket_starts[bucket];
+            const auto last = m_Suffixes.begin() + bucket_starts[bucket + 1];
+            if (last - first > 1)
+                std::sort(first, last, less);
+        }
+    };
+
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; i++)
+        pool.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : pool)
+        thread.join();
+}
+
+std::optional<size_t> SuffixIndex::ShortestUnique(const uint8_t* bytes, const uint8_t* mask, const size_t size) const
+{
+    if (size == 0 || mask[0] == 0x00 || !IsIndexed(bytes[0]))
+        return {};
+
+    // Narrow the range of suffixes that share the prefix, one byte at a time.
+    auto lo = m_Suffixes.begin();
+    auto hi = m_Suffixes.end();
+
+    size_t depth = 0;
+    for (; depth < size && depth < DEPTH && mask[depth] != 0x00; depth++)
+    {
+        const int value = bytes[depth];
+        lo = std::partition_point(lo, hi, [this, depth, value](const uint32_t suffix)
+        {
+            return ByteAt(suffix, depth) < value;
+        });
+        hi = std::partition_point(lo, hi, [this, depth, value](const uint32_t suffix)
+        {
+            return ByteAt(suffix, depth) <= value;
+        });
+
+        if (hi - lo <= 1)
+            return hi - lo == 1 ? std::optional(depth + 1) : std::nullopt;
+    }
+
+    // Past a wildcard or DEPTH the order no longer helps, check the remaining candidates directly.
+    std::vector<uint32_t> candidates(lo, hi);
+    for (; depth < size; depth++)
+    {
+        if (mask[depth] == 0x00)
+            continue;
+
+        const int value = bytes[depth];
+        std::erase_if(candidates, [this, depth, value](const uint32_t suffix)
+        {
+            return ByteAt(suffix, depth) != value;
+        });
+
+        if (candidates.size() <= 1)
+            return candidates.size() == 1 ? std::optional(depth + 1) : std::nullopt;
+    }
+
+    return {};
+}
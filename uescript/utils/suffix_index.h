@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class PEImage;
+
+/**
+ * @brief Suffix array over a module's code, used to check how many times a pattern occurs without rescanning.
+ *
+ * Suffixes are only sorted by their first DEPTH bytes, which is enough to narrow a pattern down to a handful of
+ * candidates with a binary search per byte. Suffixes starting with padding (0x00 or 0xCC) are left out, so patterns
+ * must start with some other byte.
+ */
+class SuffixIndex final
+{
+public:
+    static constexpr size_t DEPTH = 32;
+
+    /**
+     * @brief Index the code range of an image. Buckets are sorted on every hardware thread.
+     */
+    explicit SuffixIndex(const PEImage& image);
+
+    /**
+     * @brief Find the shortest prefix of a pattern that matches exactly once in the indexed range. Runs in
+     *        O(length * log n) while the prefix is wildcard-free and within DEPTH, then filters what is left.
+     * @param mask 0xFF for concrete bytes, 0x00 for wildcards
+     * @return The prefix length, or an empty optional if the whole pattern does not match exactly once or does not
+     *         start with an indexed byte
+     */
+    std::optional<size_t> ShortestUnique(const uint8_t* bytes, const uint8_t* mask, size_t size) const;
+
+    /**
+     * @return Whether suffixes starting with a byte are indexed.
+     */
+    static bool IsIndexed(const uint8_t first)
+    {
+        return first != 0x00 && first != 0xCC;
+    }
+
+    const uint8_t* Begin() const
+    {
+        return m_Begin;
+    }
+
+    const uint8_t* End() const
+    {
+        return m_End;
+    }
+
+    size_t Size() const
+    {
+        return m_Suffixes.size();
+    }
+
+private:
+    /**
+     * @return The byte at depth into a suffix, -1 past the end of the range.
+     */
+    int ByteAt(uint32_t suffix, size_t depth) const
+    {
+        const size_t offset = suffix + depth;
+        return offset < static_cast<size_t>(m_End - m_Begin) ? m_Begin[offset] : -1;
+    }
+
+    const uint8_t* m_Begin{nullptr};
+    const uint8_t* m_End{nullptr};
+    /** Offsets from m_Begin, sorted by the first DEPTH bytes of the suffix **/
+    std::vector<uint32_t> m_Suffixes{};
+};
@@ -0,0 +1,370 @@
+#include "xref_scanner.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define XREF_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define XREF_SSE2
+#endif
+
+static constexpr int8_t NO_MODRM_MEMORY = -1;
+/** The immediate depends on the reg field of the ModRM byte (group 3, test/not/neg/mul/div) **/
+static constexpr int8_t GROUP_3 = -2;
+
+/**
+ * @brief Immediate size of one-byte opcodes that take a ModRM memory operand.
+ */
+static constexpr std::array<int8_t, 256> OneByteImmediate = []
+{
+    std::array<int8_t, 256> table{};
+    table.fill(NO_MODRM_MEMORY);
+
+    // add, or, adc, sbb, and, sub, xor, cmp with a register.
+    for (int op = 0x00; op < 0x40; op += 8)
+    {
+        for (int form = 0; form < 4; form++)
+            table[op + form] = 0;
+    }
+
+    // movsxd, test, xchg, mov, lea, pop, shifts by 1 or cl, inc/dec/call/jmp/push.
+    for (const int op : {0x63, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8D, 0x8F, 0xD0, 0xD1, 0xD2, 0xD3, 0xFE,
+                         0xFF})
+        table[op] = 0;
+
+    // Group 1 with imm8, shifts by imm8, mov imm8, imul imm8.
+    for (const int op : {0x80, 0x83, 0xC0, 0xC1, 0xC6, 0x6B})
+        table[op] = 1;
+
+    // Group 1 with imm32, mov imm32, imul imm32.
+    for (const int op : {0x81, 0xC7, 0x69})
+        table[op] = 4;
+
+    table[0xF6] = GROUP_3;
+    table[0xF7] = GROUP_3;
+    return table;
+}();
+
+/**
+ * @brief Immediate size of 0F-prefixed opcodes that take a ModRM memory operand.
+ */
+static constexpr std::array<int8_t, 256> TwoByteImmediate = []
+{
+    std::array<int8_t, 256> table{};
+    table.fill(NO_MODRM_MEMORY);
+
+    // cmovcc, setcc.
+    for (int op = 0; op < 16; op++)
+    {
+        table[0x40 + op] = 0;
+        table[0x90 + op] = 0;
+    }
+
+    // SSE moves and arithmetic, movzx/movsx, imul, prefetch.
+    for (const int op : {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x28, 0x29, 0x2A, 0x2C, 0x2D, 0x2E, 0x2F,
+                         0x51, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x6E, 0x6F, 0x7E,
+                         0x7F, 0xAF, 0xB6, 0xB7, 0xBE, 0xBF, 0xD6, 0xE7, 0xEF})
+        table[op] = 0;
+
+    // pshufd, bt group, cmpps, shufps.
+    for (const int op : {0x70, 0xBA, 0xC2, 0xC6})
+        table[op] = 1;
+
+    return table;
+}();
+
+static bool IsRex(const uint8_t byte)
+{
+    return (byte & 0xF0) == 0x40;
+}
+
+static bool IsLegacyPrefix(const uint8_t byte)
+{
+    return byte == 0x66 || byte == 0xF2 || byte == 0xF3;
+}
+
+/**
+ * @brief Walk back over a REX prefix and up to two operand size/mandatory prefixes.
+ */
+static const uint8_t* IncludePrefixes(const uint8_t* begin, const uint8_t* opcode)
+{
+    const uint8_t* start = opcode;
+    if (start > begin && IsRex(start[-1]))
+        start--;
+
+    for (int i = 0; i < 2 && start > begin && IsLegacyPrefix(start[-1]); i++)
+        start--;
+
+    return start;
+}
+
+const uint8_t* XrefScanner::DecodeReference(const uint8_t* begin, const uint8_t* displacement,
+                                            const size_t immediate_size)
+{
+    const ptrdiff_t available = displacement - begin;
+    if (available < 1)
+        return nullptr;
+
+    const uint8_t* d = displacement;
+
+    // call/jmp rel32
+    if (immediate_size == 0 && (d[-1] == 0xE8 || d[-1] == 0xE9))
+        return d - 1;
+
+    // jcc rel32
+    if (immediate_size == 0 && available >= 2 && d[-2] == 0x0F && (d[-1] & 0xF0) == 0x80)
+        return d - 2;
+
+    // Everything else needs an opcode and a ModRM byte with mod = 00, r/m = 101 (RIP-relative).
+    if (available < 2 || (d[-1] & 0xC7) != 0x05)
+        return nullptr;
+
+    const uint8_t modrm = d[-1];
+
+    if (available >= 3 && d[-3] == 0x0F && TwoByteImmediate[d[-2]] == static_cast<int8_t>(immediate_size))
+        return IncludePrefixes(begin, d - 3);
+
+    int8_t expected = OneByteImmediate[d[-2]];
+    if (expected == GROUP_3)
+    {
+        // Only test takes an immediate, sized by the opcode.
+        const int reg = (modrm >> 3) & 7;
+        expected = reg > 1 ? 0 : d[-2] == 0xF6 ? 1 : 4;
+    }
+
+    if (expected != static_cast<int8_t>(immediate_size))
+        return nullptr;
+
+    return IncludePrefixes(begin, d - 2);
+}
+
+/**
+ * @brief Visit every position where position + 4 + disp32 lies in [low, low + span], in address order. An immediate
+ *        after the displacement moves the end of the instruction, so callers widen the range by the largest one.
+ */
+template <typename F>
+static void ScanDisplacements(const uint8_t* begin, const uint8_t* end, const uintptr_t low, const uint32_t span,
+                              F&& visit)
+{
+    // A displacement is preceded by at least one byte of opcode.
+    const uint8_t* cur = begin + 1;
+    if (end - begin < 5)
+        return;
+    const uint8_t* last = end - 4;
+
+    const auto candidate = [low, span](const uint8_t* position, const int32_t disp)
+    {
+        const uintptr_t next = reinterpret_cast<uintptr_t>(position) + 4;
+        return static_cast<uint32_t>(next + static_cast<uintptr_t>(static_cast<intptr_t>(disp)) - low) <= span;
+    };
+
+#if defined(XREF_AVX2) || defined(XREF_SSE2)
+    // Each displacement is 4 bytes wide, so four loads at consecutive byte offsets cover every position in a block.
+    // Lane j of load k holds the displacement at block + k + 4j; adding block + k + 4j + 4 - low to it gives the
+    // referenced address relative to low, which is then compared against span as an unsigned number.
+#ifdef XREF_AVX2
+    using Vec = __m256i;
+    constexpr size_t block_size = 32;
+    const auto load = [](const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const Vec*>(p)); };
+    const auto in_range = [](const Vec value, const Vec limit)
+    {
+        const Vec hit = _mm256_cmpeq_epi32(_mm256_min_epu32(value, limit), value);
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+    };
+    const Vec limit = _mm256_set1_epi32(static_cast<int>(span));
+    const Vec step = _mm256_set1_epi32(static_cast<int>(block_size));
+    const auto lane_offsets = [](const int k)
+    {
+        return _mm256_setr_epi32(k, k + 4, k + 8, k + 12, k + 16, k + 20, k + 24, k + 28);
+    };
+    const auto add = [](const Vec a, const Vec b) { return _mm256_add_epi32(a, b); };
+    const auto broadcast = [](const uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); };
+#else
+    using Vec = __m128i;
+    constexpr size_t block_size = 16;
+    const auto load = [](const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const Vec*>(p)); };
+    // No unsigned compare in SSE2, flip the sign bits and compare signed instead.
+    const Vec sign = _mm_set1_epi32(std::numeric_limits<int32_t>::min());
+    const auto in_range = [sign](const Vec value, const Vec limit)
+    {
+        const Vec outside = _mm_cmpgt_epi32(_mm_xor_si128(value, sign), limit);
+        return ~static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(outside))) & 0xF;
+    };
+    const Vec limit = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(span)), sign);
+    const Vec step = _mm_set1_epi32(static_cast<int>(block_size));
+    const auto lane_offsets = [](const int k) { return _mm_setr_epi32(k, k + 4, k + 8, k + 12); };
+    const auto add = [](const Vec a, const Vec b) { return _mm_add_epi32(a, b); };
+    const auto broadcast = [](const uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); };
+#endif
+
+    const Vec offsets[4] = {lane_offsets(0), lane_offsets(1), lane_offsets(2), lane_offsets(3)};
+
+    if (last - cur >= static_cast<ptrdiff_t>(block_size + 3))
+    {
+        // Truncating to 32 bits is fine: the comparison is modulo 2^32 and a false positive is rechecked below.
+        Vec base = broadcast(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(cur) + 4 - low));
+
+        const uint8_t* simd_end = last - (block_size + 3);
+        for (; cur <= simd_end; cur += block_size)
+        {
+            uint32_t mask = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                uint32_t lane_mask = in_range(add(add(load(cur + k), base), offsets[k]), limit);
+                // Lane j of load k is position k + 4j, interleave so bits are in address order.
+                while (lane_mask != 0)
+                {
+                    mask |= 1u << (std::countr_zero(lane_mask) * 4 + k);
+                    lane_mask &= lane_mask - 1;
+                }
+            }
+            base = add(base, step);
+
+            while (mask != 0)
+            {
+                const uint8_t* position = cur + std::countr_zero(mask);
+                int32_t disp;
+                std::memcpy(&disp, position, sizeof(disp));
+                if (!visit(position, disp))
+                    return;
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+
+    for (; cur <= last; cur++)
+    {
+        int32_t disp;
+        std::memcpy(&disp, cur, sizeof(disp));
+        if (candidate(cur, disp) && !visit(cur, disp))
+            return;
+    }
+}
+
+/**
+ * @brief Largest immediate that can follow a displacement.
+ */
+static constexpr uint32_t MAX_IMMEDIATE = 4;
+static constexpr size_t IMMEDIATE_SIZES[] = {0, 1, 4};
+
+std::vector<Xref> XrefScanner::Find(const uint8_t* begin, const uint8_t* end, const uint8_t* target,
+                                    const size_t limit)
+{
+    std::vector<Xref> results;
+    if (begin == nullptr || end <= begin)
+        return results;
+
+    const auto target_address = reinterpret_cast<uintptr_t>(target);
+    const uintptr_t low = target_address - MAX_IMMEDIATE;
+
+    ScanDisplacements(begin, end, low, MAX_IMMEDIATE, [&](const uint8_t* position, const int32_t disp)
+    {
+        const uintptr_t next = reinterpret_cast<uintptr_t>(position) + 4 + static_cast<intptr_t>(disp);
+        for (const size_t immediate : IMMEDIATE_SIZES)
+        {
+            if (next + immediate != target_address)
+                continue;
+
+            if (const uint8_t* instruction = DecodeReference(begin, position, immediate); instruction != nullptr)
+            {
+                results.push_back({instruction, target});
+                return limit == 0 || results.size() < limit;
+            }
+        }
+        return true;
+    });
+
+    return results;
+}
+
+/**
+ * @brief Open-addressing hash set of addresses. Lookups are the hot path of FindMany.
+ */
+class AddressSet final
+{
+public:
+    explicit AddressSet(const std::vector<const uint8_t*>& addresses)
+    {
+        // Keep the load factor at or under 50%.
+        const size_t capacity = std::bit_ceil(std::max<size_t>(16, addresses.size() * 2));
+        m_Slots.assign(capacity, 0);
+        m_Mask = capacity - 1;
+
+        for (const uint8_t* address : addresses)
+        {
+            const auto key = reinterpret_cast<uintptr_t>(address);
+            if (key == 0)
+                continue;
+
+            size_t slot = Hash(key);
+            while (m_Slots[slot] != 0 && m_Slots[slot] != key)
+                slot = (slot + 1) & m_Mask;
+            m_Slots[slot] = key;
+        }
+    }
+
+    bool Contains(const uintptr_t key) const
+    {
+        for (size_t slot = Hash(key);; slot = (slot + 1) & m_Mask)
+        {
+            if (m_Slots[slot] == key)
+                return true;
+            if (m_Slots[slot] == 0)
+                return false;
+        }
+    }
+
+private:
+    size_t Hash(const uintptr_t key) const
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15) >> 32) & m_Mask;
+    }
+
+    std::vector<uintptr_t> m_Slots{};
+    size_t m_Mask{0};
+};
+
+std::vector<Xref> XrefScanner::FindMany(const uint8_t* begin, const uint8_t* end,
+                                        const std::vector<const uint8_t*>& targets)
+{
+    std::vector<Xref> results;
+    if (begin == nullptr || end <= begin || targets.empty())
+        return results;
+
+    const auto [min_target, max_target] = std::minmax_element(targets.begin(), targets.end());
+    const uintptr_t low = reinterpret_cast<uintptr_t>(*min_target) - MAX_IMMEDIATE;
+    const uintptr_t range = reinterpret_cast<uintptr_t>(*max_target) - low;
+
+    // Targets spread over more than 4 GB cannot be filtered by range, every position then goes to the set.
+    const uint32_t span = range > std::numeric_limits<uint32_t>::max()
+                              ? std::numeric_limits<uint32_t>::max()
+                              : static_cast<uint32_t>(range);
+
+    const AddressSet set(targets);
+
+    ScanDisplacements(begin, end, low, span, [&](const uint8_t* position, const int32_t disp)
+    {
+        const uintptr_t next = reinterpret_cast<uintptr_t>(position) + 4 + static_cast<intptr_t>(disp);
+        for (const size_t immediate : IMMEDIATE_SIZES)
+        {
+            if (!set.Contains(next + immediate))
+                continue;
+
+            if (const uint8_t* instruction = DecodeReference(begin, position, immediate); instruction != nullptr)
+            {
+                results.push_back({instruction, reinterpret_cast<const uint8_t*>(next + immediate)});
+                break;
+            }
+        }
+        return true;
+    });
+
+    return results;
+}
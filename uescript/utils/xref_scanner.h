@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Like pattern.h, this has no Windows or Lua dependency.
+*/
+
+/**
+ * @brief An instruction that references an address through a rel32 or RIP-relative disp32 operand.
+ */
+struct Xref
+{
+    /** Start of the referencing instruction, including prefixes **/
+    const uint8_t* Instruction;
+    /** Address the instruction references **/
+    const uint8_t* Target;
+};
+
+/**
+ * @brief Finds code that references an address, e.g. every instruction that loads GObjects or leas a string literal.
+ *
+ * Recognized forms are call/jmp/jcc rel32 and legacy or REX-prefixed instructions with a RIP-relative ModRM operand
+ * (lea, mov, cmp, call [rip+x], movss, ...), including those with an 8 or 32-bit immediate after the displacement.
+ */
+class XrefScanner final
+{
+public:
+    XrefScanner() = delete;
+
+    /**
+     * @brief Find instructions in [begin, end) that reference target.
+     * @param limit Stop after this many, 0 for no limit
+     * @return Matches in address order
+     */
+    static std::vector<Xref> Find(const uint8_t* begin, const uint8_t* end, const uint8_t* target, size_t limit = 0);
+
+    /**
+     * @brief Find instructions in [begin, end) that reference any of the targets, in a single pass.
+     * @return Matches in address order
+     */
+    static std::vector<Xref> FindMany(const uint8_t* begin, const uint8_t* end,
+                                      const std::vector<const uint8_t*>& targets);
+
+    /**
+     * @brief Check whether the bytes before a 32-bit displacement form an instruction that is recognized.
+     * @param begin Start of the code, nothing before this is read
+     * @param displacement Address of the displacement
+     * @param immediate_size Size of the immediate after the displacement (0, 1 or 4)
+     * @return Start of the instruction or nullptr
+     */
+    static const uint8_t* DecodeReference(const uint8_t* begin, const uint8_t* displacement, size_t immediate_size);
+};